@@ -36,6 +36,10 @@ extern "C" {
 // ----	Constants -------------------------------------------------------------
 // ============================================================================
 
+#if (BOARD_BUTTONS_MATRIX)
+#error "the GTK panel has 8 push buttons and no keypad matrix; build this board w/ BOARD_BUTTONS_MATRIX 0"
+#endif
+
 /** Button IDs for this board. */
 enum eBoardButtons
 {
@@ -51,6 +55,14 @@ enum eBoardButtons
 	kBoardNumButtons
 };
 
+/** Analog inputs: the panel's rheostats, when #BOARD_ANALOG is set. */
+enum eBoardAnalogs
+{
+	kBoardAnalog0,
+	kBoardAnalog1,
+	kBoardNumAnalogs
+};
+
 enum eBoardLeds
 {
 	kBoardLed1,
@@ -65,6 +77,15 @@ enum eBoardLeds
 // ----	Type Definitions ------------------------------------------------------
 // ============================================================================
 
+/// Heartbeat (1 ms tick) statistics; see `Get(Cwsw_Board, TickStats)`.
+typedef struct sBoardTickStats {
+	uint32_t	ticks;			//!< ticks delivered since init
+	uint32_t	catchup;		//!< of those, ticks delivered back-to-back because the main loop was late
+	uint32_t	latewakeups;	//!< wakeups that found more than one tick due
+	uint32_t	skipped;		//!< ticks abandoned after falling more than BOARD_TICK_MAX_CATCHUP behind
+	uint32_t	maxlate_us;		//!< worst lateness of a wakeup, in microseconds
+} tBoardTickStats;
+
 // ============================================================================
 // ----	Public Variables ------------------------------------------------------
 // ============================================================================
@@ -76,6 +97,36 @@ enum eBoardLeds
 // ---- Discrete Functions -------------------------------------------------- {
 extern uint16_t	bd_gtk__Init(void);
 
+/** Build the panel and put it on screen, if it isn't already.
+ *	Cwsw_Board__Init() calls this unless #BOARD_GTK_DEFER_PANEL is set; until it succeeds, the
+ *	board runs headless (buttons read "released" unless pushed w/ bd_gtk__PushButton(), LEDs are
+ *	kept in the image only).
+ *	@returns #kErr_Board_NoPanel if there is no display; #kErr_Bsp_InitFailed if the UI description
+ *	can't be loaded or lacks a widget the board is wired to.
+ */
+extern uint16_t	bd_gtk__ShowPanel(void);
+
+/** Feed one button edge to the board, as the panel's button callbacks do.
+ *	Lets a headless run (a batch test, say) drive the buttons w/out a display.
+ *	@returns false if the edge ring was full and the edge was dropped.
+ */
+extern bool		bd_gtk__PushButton(uint16_t button, bool pressed);
+
+#if (BOARD_ANALOG)
+/** Set the level analog input `channel` reads, in ADC counts, as moving its rheostat does.
+ *	Lets a headless run drive the analog inputs w/out a display.
+ */
+extern void		bd_gtk__SetAnalog(uint32_t channel, uint16_t value);
+#endif
+
+/** Bring a sleeping (tickless-idle) heartbeat back to 1 ms ticks.
+ *	Called by the UI callbacks when input arrives, so a button press isn't left waiting for the
+ *	next scheduled deadline. Ticks that elapsed while asleep are delivered on the next wakeup.
+ *	May also be called from a task: inside the heartbeat, it only shortens the heartbeat's next sleep
+ *	to one tick.
+ */
+extern void		bd_gtk__Wake(void);
+
 // ---- /Discrete Functions ------------------------------------------------- }
 
 // ---- Targets for Get/Set APIs -------------------------------------------- {
@@ -114,9 +165,14 @@ extern void Cwsw_Board__Set_kBoardLed3(bool value);
 extern void Cwsw_Board__Set_kBoardLed4(bool value);
 /**	@} */
 
-/** Target 1 for TM(tmr) */
-#define GET_tmrdebounce()	Cwsw_GetTimeLeft(tmrdebounce)	/* timer local to one SM state */
-#define GET_tmrPressed()	Cwsw_GetTimeLeft(tmrPressed)	/* timer local to one SM state */
+/** Target for `Get(Cwsw_Board, TickStats)`.
+ *	Snapshot of the heartbeat's timing statistics. A tick is never lost silently: it is delivered
+ *	on time, delivered late (`catchup`), or counted in `skipped`.
+ */
+extern tBoardTickStats Cwsw_Board__Get_TickStats(void);
+
+/** Target for `Get(bd_gtk, PanelShown)`: false while the board runs headless. */
+extern bool bd_gtk__Get_PanelShown(void);
 
 // ---- /Targets for Get/Set APIs ------------------------------------------- }
 
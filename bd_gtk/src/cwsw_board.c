@@ -3,7 +3,7 @@
  *
  *	In the same way my Microchip MZ demo board, or my NXP 5748G demo board, or my STI demo board, all
  *	have some general purpose buttons, rheostats, LEDs, and displays, so here does the GTK "board" have
- *	a panel that has 8 buttons, 8 "LEDs", and a text box.
+ *	a panel that has 8 buttons, 8 "LEDs", and a text box; w/ #BOARD_ANALOG, also 2 rheostats.
  *
  *	\copyright
  *	Copyright (c) 2020 Kevin L. Becker. All rights reserved.
@@ -18,12 +18,17 @@
 
 // ----	System Headers --------------------------
 #include <stdbool.h>
+#include <string.h>			/* memcpy() */
 
 // ----	Project Headers -------------------------
 #include "cwsw_arch.h"		// Get(Initialized)
 
 // ----	Module Headers --------------------------
 #include "cwsw_board.h"
+#include "cwsw_bsp_buttons.h"		/* Btn_SetEventQueue() */
+#include "cwsw_bsp_ledpwm.h"		/* di_led_pwm_apply() */
+#include "cwsw_bsp_analog.h"		/* Ain_SetEventQueue() */
+#include "cwsw_bsp_display.h"		/* tBoardDisplay */
 
 //#include "ManagedAlarms.h"	// temporary until i get architecture sorted out. the BSP should not know about
 //#include "tedlosevents.h"
@@ -45,11 +50,91 @@ enum sButtonSignals {
 	kBtnActivate
 };
 
+/// Heartbeat period, in microseconds of GLib's monotonic clock.
+#define kTickPeriodUs		1000
+
+#if !defined(BOARD_GTK_UI_FILE)
+/** UI panel description, loaded at run time when neither #BOARD_GTK_UI_RESOURCE nor
+ *	#BOARD_GTK_UI_STRING is defined. Relative to the working directory (by default, that of the
+ *	Eclipse project).
+ */
+#define BOARD_GTK_UI_FILE		"../../cwsw_cfg/bsp/gtkboard.ui"
+#endif
+
+/*	The panel can instead be built into the executable, so the board starts w/out any file:
+ *	-	BOARD_GTK_UI_RESOURCE: GResource path of the UI description, e.g. "/cwsw/bsp/gtkboard.ui";
+ *		the project compiles it w/ `glib-compile-resources --generate-source` and links the result.
+ *	-	BOARD_GTK_UI_STRING: the UI description itself, as a string literal (e.g., generated from
+ *		the .ui file by the build).
+ */
+
+#if !defined(BOARD_GTK_DISPLAY_ID)
+/** "ID" of the panel's text box (a GtkTextView), when #BOARD_DISPLAY is set. A panel w/out one
+ *	still loads; the display is then kept in the back buffer only.
+ */
+#define BOARD_GTK_DISPLAY_ID	"txtDisplay"
+#endif
+
+#if !defined(BOARD_GTK_DEFER_PANEL)
+/** When 1, Cwsw_Board__Init() leaves the panel alone; it is built by bd_gtk__ShowPanel(), if and
+ *	when a display is wanted. When 0, Init builds it, unless there is no display.
+ */
+#define BOARD_GTK_DEFER_PANEL	0
+#endif
+
+#if !defined(BOARD_TICK_MAX_CATCHUP)
+/** Most ticks delivered back-to-back when the main loop was late.
+ *	Beyond this (e.g., the process was stopped in a debugger), the heartbeat gives up on the
+ *	missed ticks, counts them as skipped, and re-synchronizes to "now".
+ */
+#define BOARD_TICK_MAX_CATCHUP	50
+#endif
+
+#if !defined(BOARD_TICKLESS_IDLE)
+/** Tickless idle.
+ *	When 1, the heartbeat asks `cbNEXT_DEADLINE()` how many ticks remain until anything is due, and
+ *	lets the main loop block that long (or until UI input arrives, see bd_gtk__Wake()). The ticks are
+ *	not lost: they are delivered back-to-back when the heartbeat wakes, so the clock stays right.
+ *	When 0, the heartbeat wakes every tick.
+ */
+#define BOARD_TICKLESS_IDLE		0
+#endif
+
+#if !defined(BOARD_TICKLESS_MAX_SLEEP)
+/// Longest the heartbeat sleeps in tickless idle, in ticks, however far away the next deadline is.
+#define BOARD_TICKLESS_MAX_SLEEP	100
+#endif
+
+#if (BOARD_TICKLESS_IDLE) && !defined(cbNEXT_DEADLINE)
+#error "tickless idle needs the project to define cbNEXT_DEADLINE(): ticks until the next pending alarm"
+#endif
+
+#if !defined(cbHEARTBEAT_ACTION)
+/** Work done once per 1 ms tick; the project defines this in projcfg.h, typically as
+ *	`tedlos_schedule(pOsEvqx)`. The board itself doesn't know which scheduler it feeds.
+ */
+#define cbHEARTBEAT_ACTION()
+#endif
+
+/// Kinds of panel widget the board binds to.
+enum eUiBindKind {
+	kUiBindButton,
+	kUiBindLed,
+	kUiBindAnalog
+};
+
 
 // ========================================================================== }
 // ----	Type Definitions ------------------------------------------------------
 // ========================================================================== {
 
+/// One row of the board's wiring: which panel widget simulates which button or LED.
+typedef struct sUiBinding {
+	const char	*uiid;		//!< "ID" field of the widget in the UI panel
+	uint8_t		kind;		//!< #eUiBindKind
+	uint8_t		index;		//!< button ID (#eBoardButtons), LED ID (#eBoardLeds) or analog channel (#eBoardAnalogs)
+} tUiBinding;
+
 // ========================================================================== }
 // ----	Global Variables ------------------------------------------------------
 // ========================================================================== {
@@ -60,6 +145,26 @@ enum sButtonSignals {
 
 static bool initialized = false;
 
+/// The board's wiring. Adding a button or LED to the panel is one row here.
+static const tUiBinding uibindings[] = {
+	{ "btn0", kUiBindButton,	kBoardButton0 },
+	{ "btn1", kUiBindButton,	kBoardButton1 },
+	{ "btn2", kUiBindButton,	kBoardButton2 },
+	{ "btn3", kUiBindButton,	kBoardButton3 },
+	{ "btn4", kUiBindButton,	kBoardButton4 },
+	{ "btn5", kUiBindButton,	kBoardButton5 },
+	{ "btn6", kUiBindButton,	kBoardButton6 },
+	{ "btn7", kUiBindButton,	kBoardButton7 },
+	{ "ind0", kUiBindLed,		kBoardLed1 },
+	{ "ind1", kUiBindLed,		kBoardLed2 },
+	{ "ind2", kUiBindLed,		kBoardLed3 },
+	{ "ind3", kUiBindLed,		kBoardLed4 },
+#if (BOARD_ANALOG)
+	{ "rheo0", kUiBindAnalog,	kBoardAnalog0 },
+	{ "rheo1", kUiBindAnalog,	kBoardAnalog1 },
+#endif
+};
+
 static int    argc = 0;
 static char **argv = NULL;
 
@@ -67,113 +172,427 @@ static char **argv = NULL;
 static GObject *btnQuit		= NULL;
 
 static GtkBuilder *pUiPanel	= NULL;
-static GObject *pWindow		= NULL;
+static GObject *pWindow		= NULL;		//!< the panel; NULL while the board runs headless
 static GError *error		= NULL;
+static bool gtkready		= false;	//!< gtk_init_check() has found a display
+
+/* GLib timeouts drift, and are coalesced when the main loop is busy. the heartbeat therefore keeps
+ * its own schedule on the monotonic clock, and on each wakeup delivers every tick that has come
+ * due since the last one; the schedule advances by whole periods, never from "now", so it does not
+ * accumulate drift.
+ */
+static gint64 tmNextTick			= 0;		//!< monotonic time (us) at which the next tick is due
+static gint64 tmPlannedWake			= 0;		//!< monotonic time (us) at which the heartbeat means to wake
+static guint hbsource				= 0;		//!< GLib source ID of the armed heartbeat
+static uint32_t hbperiod			= 0;		//!< period, in ticks, of the armed heartbeat
+static bool hbdispatching			= false;	//!< tmHeartbeat() is running; only it may re-arm itself
+static bool hbwakepending			= false;	//!< bd_gtk__Wake() was called from inside tmHeartbeat()
+static guint idlesource				= 0;		//!< GLib source ID of the pending idle pass, if any
+static tBoardTickStats tickstats	= {0};
+
+/* LED handles are resolved once, at init. Writes land in the shadow image and set a dirty bit;
+ * the idle callback pushes only dirty indicators to GTK, so a fast-blinking task costs one redraw
+ * per frame rather than one per write. W/ dimming, the heartbeat re-evaluates the output image
+ * every tick, and only indicators whose output changed are marked dirty.
+ */
+static GObject *ledhandles[kBoardNumLeds]	= {NULL};
+static uint32_t ledshadow	= 0;		//!< bitmapped LED image, as last written by the application
+static uint32_t ledoutput	= 0;		//!< what the indicators should show: the shadow, after dimming
+static uint32_t leddirty	= 0;		//!< LEDs whose output differs from what GTK is showing
+#if (BOARD_LED_PWM)
+static tBoardLedPwm ledpwm	= {0};
+#endif
+
+#if (BOARD_DISPLAY)
+/* the application writes the back buffer; the idle callback pushes each line's dirty span to the
+ * text box, where it replaces just those characters, so GTK re-lays-out one line, not the view.
+ */
+static tBoardDisplay display;
+static GtkTextBuffer *pDisplayBuf	= NULL;		//!< the text box's buffer; NULL while headless
+#endif
 
 
 // ========================================================================== }
 // ----	Private Functions -----------------------------------------------------
 // ========================================================================== {
-// time handling from demo @ http://zetcode.com/gui/gtk2/gtkevents/
-//	this one designed to be called @ 1ms intervals. it is intended to simulate a 1ms heartbeat tic
-//	from a real exercise kit.
-static gboolean
-tmHeartbeat(GtkWidget *widget)
+/// Push the indicators that changed since the last flush to GTK.
+static void
+FlushLeds(void)
 {
-	UNUSED(widget);
-//	cbHEARTBEAT_ACTION();	<<== defined as `tedlos_schedule(pOsEvqx)`
-	return (gboolean)true;
+	uint32_t led;
+	for(led = 0; leddirty && (led < kBoardNumLeds); ++led)
+	{
+		if(!BIT_TEST(leddirty, led))	{ continue; }
+		BIT_CLR(leddirty, led);
+		if(ledhandles[led])
+		{
+			gtk_toggle_button_set_active((GtkToggleButton *)ledhandles[led], (gboolean)(BIT_TEST(ledoutput, led) != 0));
+		}
+	}
 }
 
+#if (BOARD_DISPLAY)
+/// Replace `len` characters of the text box at line `row`, column `col`.
+static void
+ShowDisplaySpan(uint32_t row, uint32_t col, const char *text, uint32_t len)
+{
+	GtkTextIter start, end;
+
+	gtk_text_buffer_get_iter_at_line_offset(pDisplayBuf, &start, (gint)row, (gint)col);
+	gtk_text_buffer_get_iter_at_line_offset(pDisplayBuf, &end, (gint)row, (gint)(col + len));
+	gtk_text_buffer_delete(pDisplayBuf, &start, &end);		// revalidates `start` to the deletion point
+	gtk_text_buffer_insert(pDisplayBuf, &start, text, (gint)len);
+}
+
+/** Bind the panel's text box, and paint the whole back buffer into it.
+ *	The box then holds exactly #BOARD_DISPLAY_ROWS lines of #BOARD_DISPLAY_COLS characters, so a
+ *	line and column of the display is a line and offset of the box.
+ */
+static void
+BindDisplay(GObject *pobj)
+{
+	char screen[BOARD_DISPLAY_ROWS * (BOARD_DISPLAY_COLS + 1)];
+	char *pscreen = screen;
+	uint32_t row;
+
+	if(!pobj || !GTK_IS_TEXT_VIEW(pobj))	{ return; }
+	pDisplayBuf = gtk_text_view_get_buffer((GtkTextView *)pobj);
+	gtk_text_view_set_monospace((GtkTextView *)pobj, (gboolean)true);
 
+	for(row = 0; row < BOARD_DISPLAY_ROWS; ++row)
+	{
+		memcpy(pscreen, display.text[row], BOARD_DISPLAY_COLS);
+		pscreen += BOARD_DISPLAY_COLS;
+		*pscreen++ = '\n';
+	}
+	gtk_text_buffer_set_text(pDisplayBuf, screen, (gint)(sizeof(screen) - 1));		// no '\n' after the last line
+}
+#endif
+
+/// One idle pass: runs once each time something queues idle work, not continuously.
 static gboolean
 gtkidle(gpointer user_data)
 {
 	UNUSED(user_data);
+	idlesource = 0;
+	FlushLeds();
+#if (BOARD_DISPLAY)
+	if(pDisplayBuf)	{ di_display_flush(&display, ShowDisplaySpan); }
+#endif
 //	cdIDLE_ACTION();		<<== tbd
-	return (gboolean)true;
+	return (gboolean)false;
 }
 
+/// Schedule one idle pass, if one isn't already pending.
+static void
+ArmIdle(void)
+{
+	if(!idlesource)	{ idlesource = g_idle_add(gtkidle, NULL); }
+}
 
-// ========================================================================== }
-// ----	Public Functions ------------------------------------------------------
-// ========================================================================== {
+/// Work out this tick's output image, and mark the indicators it changes as dirty.
+static void
+UpdateLeds(void)
+{
+#if (BOARD_LED_PWM)
+	uint32_t out = di_led_pwm_apply(&ledpwm, ledshadow, Get(Cwsw_Clock, Now));
+#else
+	uint32_t out = ledshadow;
+#endif
+
+	if(out == ledoutput)	{ return; }
+	leddirty |= out ^ ledoutput;
+	ledoutput = out;
+	ArmIdle();
+}
 
-// ---- General Functions --------------------------------------------------- {
-uint16_t
-Cwsw_Board__Init(ptEvQ_QueueCtrlEx pEvQX)
+/// Record an LED write in the shadow image; a write that doesn't change the value is a no-op.
+static void
+SetLed(uint32_t led, bool value)
 {
-	bool bad_init = false;
-	if(!Get(Cwsw_Arch, Initialized)) { return kErr_Lib_NotInitialized; }
+	if(led >= kBoardNumLeds)	{ return; }
+	if(value)	{ BIT_SET(ledshadow, led); }
+	else		{ BIT_CLR(ledshadow, led); }
+	UpdateLeds();
+}
 
-	// initialize gtk lib. in this environment, no command line options are available.
-	gtk_init(&argc, &argv);
+static gboolean tmHeartbeat(GtkWidget *widget);
 
-	/* Construct a GtkBuilder instance and load our UI description */
-	pUiPanel = gtk_builder_new();
+/** (Re-)arm the heartbeat to wake after `ticks` more ticks have come due.
+ *	@returns true if the currently-armed source already has that period and may keep running;
+ *	false if a new source was created (the caller, if it is the old source, should go away).
+ */
+static gboolean
+ArmHeartbeat(tCwswClockTics ticks)
+{
+	gint64 now = g_get_monotonic_time();
+
+	if(ticks < 1)							{ ticks = 1; }
+	if(ticks > BOARD_TICKLESS_MAX_SLEEP)	{ ticks = BOARD_TICKLESS_MAX_SLEEP; }
 
-	/* Note: hard-coded location of UI panel. relative to the location of the Eclipse project. */
-	if(gtk_builder_add_from_file(pUiPanel, "../../cwsw_cfg/bsp/gtkboard.ui", &error) == 0)
+	// ticks that come due before the planned wakeup are intentional; they are not "late"
+	tmPlannedWake = tmNextTick + ((gint64)(ticks - 1) * kTickPeriodUs);
+	if(tmPlannedWake < now)	{ tmPlannedWake = now; }
+
+	if(hbsource && (hbperiod == (uint32_t)ticks))	{ return (gboolean)true; }
+	hbperiod = (uint32_t)ticks;
+	hbsource = g_timeout_add_full(G_PRIORITY_HIGH, hbperiod, (GSourceFunc) tmHeartbeat, (gpointer)pWindow, NULL);
+	return (gboolean)false;
+}
+
+// time handling from demo @ http://zetcode.com/gui/gtk2/gtkevents/
+//	this one designed to be called @ 1ms intervals. it is intended to simulate a 1ms heartbeat tic
+//	from a real exercise kit. w/ tickless idle, it may be called less often; it then delivers the
+//	ticks that came due while it slept, back-to-back.
+static gboolean
+tmHeartbeat(GtkWidget *widget)
+{
+	extern void di_button_wake(void);
+	gint64 now = g_get_monotonic_time();
+	gint64 late = now - tmPlannedWake;
+	uint32_t due, extra;
+	tCwswClockTics ticks;
+	UNUSED(widget);
+
+	if(now < tmNextTick)	{ return (gboolean)true; }	// woken early; nothing due yet
+
+	due = (uint32_t)((now - tmNextTick) / kTickPeriodUs) + 1;
+	extra = (late > 0) ? (uint32_t)(late / kTickPeriodUs) : 0;	// ticks due after the planned wakeup
+	if(late > (gint64)UINT32_MAX)				{ late = (gint64)UINT32_MAX; }	// only the statistic saturates
+	if((late > 0) && ((uint32_t)late > tickstats.maxlate_us))	{ tickstats.maxlate_us = (uint32_t)late; }
+	if(extra)	{ ++tickstats.latewakeups; }
+
+	if(extra > BOARD_TICK_MAX_CATCHUP)
 	{
-		g_printerr("Error loading file: %s\n", error->message);
-		g_clear_error(&error);
-		return kErr_Bsp_InitFailed;
+		// re-sync: give up on the oldest missed ticks
+		tickstats.skipped += extra - BOARD_TICK_MAX_CATCHUP;
+		tmNextTick += (gint64)(extra - BOARD_TICK_MAX_CATCHUP) * kTickPeriodUs;
+		due -= extra - BOARD_TICK_MAX_CATCHUP;
+		extra = BOARD_TICK_MAX_CATCHUP;
 	}
+	tickstats.catchup += extra;
 
-	/* Connect signal handlers to the constructed widgets. */
-	// here & below: reaction to bad "connection" call from https://developer.gnome.org/gtk3/stable/GtkWidget.html#gtk-widget-destroy
-	pWindow = gtk_builder_get_object (pUiPanel, "GTK_Board");		// run-time association, must match "ID" field.
-	if(pWindow)
+	hbdispatching = true;
+	di_button_wake();		// UI edges wake an idle button scan from here, not from the UI callbacks
+	while(due--)
+	{
+		cbHEARTBEAT_ACTION();	// usually defined as `tedlos_schedule(pOsEvqx)`
+		++tickstats.ticks;
+		tmNextTick += kTickPeriodUs;
+	}
+#if (BOARD_LED_PWM)
+	UpdateLeds();
+#endif
+	ArmIdle();
+	hbdispatching = false;
+
+#if (BOARD_TICKLESS_IDLE) && (BOARD_LED_PWM)
+	// a dimmed LED that is on needs every tick
+	ticks = (ledpwm.dimmed & ledshadow) ? 1 : cbNEXT_DEADLINE();
+#elif (BOARD_TICKLESS_IDLE)
+	ticks = cbNEXT_DEADLINE();
+#else
+	ticks = 1;
+#endif
+	if(hbwakepending)
 	{
-		// ok, good, we have a window. now initialize the contents.
-		extern bool di_button_init(GtkBuilder *pUiPanel, ptEvQ_QueueCtrlEx pEvQX);
+		hbwakepending = false;
+		ticks = 1;
+	}
+	return ArmHeartbeat(ticks);
+}
 
-		// make the "x" in the window upper-right corner close the window
-		g_signal_connect(pWindow, "destroy", G_CALLBACK(gtk_main_quit), NULL);
-		btnQuit = gtk_builder_get_object(pUiPanel, "btnQuit");
-		if(!btnQuit)	{ bad_init = true; }
+/** Build the panel from its UI description, and wire its widgets to the board.
+ *	On failure, whatever was built is torn down again, and the failure is the caller's to report:
+ *	Cwsw_Board__Init() returns #kErr_Bsp_InitFailed, rather than hide a broken panel behind a
+ *	headless run. Only a missing display (see bd_gtk__ShowPanel()) lets the board carry on headless.
+ *	@returns true on failure.
+ */
+static bool
+LoadPanel(void)
+{
+	extern bool di_button_bind(GObject *pbtn, uint32_t button);
+#if (BOARD_ANALOG)
+	extern bool di_analog_bind(GObject *prange, uint32_t channel);
+#endif
+	bool bad_init = false;
+	guint loaded;
+	uint32_t row;
 
-		if(!bad_init)		// connect quit, get handles for buttons
-		{
-			// make the quit button an alias for the "X"
-			g_signal_connect(btnQuit, "clicked", G_CALLBACK(gtk_main_quit), NULL);
+	/* Construct a GtkBuilder instance and load our UI description */
+	pUiPanel = gtk_builder_new();
+#if defined(BOARD_GTK_UI_RESOURCE)
+	loaded = gtk_builder_add_from_resource(pUiPanel, BOARD_GTK_UI_RESOURCE, &error);
+#elif defined(BOARD_GTK_UI_STRING)
+	loaded = gtk_builder_add_from_string(pUiPanel, BOARD_GTK_UI_STRING, -1, &error);
+#else
+	loaded = gtk_builder_add_from_file(pUiPanel, BOARD_GTK_UI_FILE, &error);
+#endif
+	if(!loaded)
+	{
+		g_printerr("Error loading UI panel: %s\n", error->message);
+		g_clear_error(&error);
+		g_object_unref(pUiPanel);
+		pUiPanel = NULL;
+		return true;
+	}
 
-			bad_init = di_button_init(pUiPanel, pEvQX);
-		}
+	// here & below: reaction to bad "connection" call from https://developer.gnome.org/gtk3/stable/GtkWidget.html#gtk-widget-destroy
+	pWindow = gtk_builder_get_object(pUiPanel, "GTK_Board");		// run-time association, must match "ID" field.
+	btnQuit = gtk_builder_get_object(pUiPanel, "btnQuit");
+	if(!pWindow || !btnQuit)	{ bad_init = true; }
+
+	// wire up buttons and indicators; nothing looks a widget up by name after this
+	for(row = 0; !bad_init && (row < TABLE_SIZE(uibindings)); ++row)
+	{
+		GObject *pobj = gtk_builder_get_object(pUiPanel, uibindings[row].uiid);	// run-time association w/ "ID" field in UI
+		if(!pobj)	{ bad_init = true; continue; }
 
-		if(!bad_init)		// set up 1ms heartbeat
+		switch(uibindings[row].kind)
 		{
-			g_timeout_add(1, (GSourceFunc) tmHeartbeat, (gpointer)pWindow);		/* hard-coded 1 ms tic rate */
+		case kUiBindButton:
+			bad_init = di_button_bind(pobj, uibindings[row].index);
+			break;
+
+		case kUiBindLed:
+			if(uibindings[row].index < kBoardNumLeds)	{ ledhandles[uibindings[row].index] = pobj; }
+			else										{ bad_init = true; }
+			break;
+
+#if (BOARD_ANALOG)
+		case kUiBindAnalog:
+			bad_init = di_analog_bind(pobj, uibindings[row].index);
+			break;
+#endif
+
+		default:
+			bad_init = true;
+			break;
 		}
+	}
 
-		// set up idle callback
-	    g_idle_add (gtkidle, NULL);
+#if (BOARD_DISPLAY)
+	if(!bad_init)	{ BindDisplay(gtk_builder_get_object(pUiPanel, BOARD_GTK_DISPLAY_ID)); }
+#endif
 
+	if(bad_init)
+	{
+		if(pWindow)	{ gtk_widget_destroy((GtkWidget *)pWindow); }
+		for(row = 0; row < kBoardNumLeds; ++row)	{ ledhandles[row] = NULL; }
+#if (BOARD_DISPLAY)
+		pDisplayBuf = NULL;
+#endif
+		pWindow = btnQuit = NULL;
+		g_object_unref(pUiPanel);
+		pUiPanel = NULL;
+		return true;
 	}
 
-	if(bad_init)
+	// make the "x" in the window upper-right corner close the window, and the quit button an alias for it
+	g_signal_connect(pWindow, "destroy", G_CALLBACK(gtk_main_quit), NULL);
+	g_signal_connect(btnQuit, "clicked", G_CALLBACK(gtk_main_quit), NULL);
+
+	// the panel's initial indicator states are whatever the UI file says; force the 1st flush.
+	leddirty = (1UL << kBoardNumLeds) - 1;
+	ArmIdle();
+	return false;
+}
+
+// ========================================================================== }
+// ----	Public Functions ------------------------------------------------------
+// ========================================================================== {
+
+// ---- General Functions --------------------------------------------------- {
+uint16_t
+Cwsw_Board__Init(ptEvQ_QueueCtrlEx pEvQX)
+{
+	extern bool di_button_init(ptEvQ_QueueCtrlEx pEvQX);
+
+	if(!Get(Cwsw_Arch, Initialized)) { return kErr_Lib_NotInitialized; }
+#if (BOARD_DISPLAY)
+	di_display_init(&display);		// before the panel is built; it paints from the back buffer
+#endif
+
+#if !(BOARD_GTK_DEFER_PANEL)
 	{
-		gtk_widget_destroy((GtkWidget *)pWindow);
-		return kErr_Bsp_InitFailed;
+		/* w/out a display (e.g., a batch run on a build server), the board runs headless: the
+		 *	heartbeat, buttons and LED image all work, there is just nothing to look at.
+		 */
+		uint16_t rc = bd_gtk__ShowPanel();
+		if(rc == kErr_Board_NoPanel)	{ g_printerr("No display; the GTK board runs w/out its panel.\n"); }
+		else if(rc)						{ return rc; }
 	}
+#endif
 
-	TODO: SET BUTTON QUEUE HERE
+	// debounced button notifications go to the queue the board was given; the application
+	//	routes the scan alarm w/ Btn_SetAlarmQueue(), and may add a priority lane.
+	Btn_SetEventQueue(pEvQX);
+	(void)di_button_init(pEvQX);
+#if (BOARD_ANALOG)
+	Ain_SetEventQueue(pEvQX);		// threshold events share the button queue
+#endif
 
-	SET(kBoardLed1, kLogicalOff);
-	SET(kBoardLed2, kLogicalOff);
-	SET(kBoardLed3, kLogicalOff);
-	SET(kBoardLed4, kLogicalOff);
+	// high priority, so redraws don't starve it; tmHeartbeat() makes up for late wakeups.
+	tmNextTick = g_get_monotonic_time() + kTickPeriodUs;
+	(void)ArmHeartbeat(1);		/* hard-coded 1 ms tic rate */
+
+	// the idle callback runs on demand (LED changes, after each heartbeat), rather than spinning
+	Set(Cwsw_Board, LedMask, 0);
+	ArmIdle();
 
 	initialized = true;
 	return kErr_Bsp_NoError;
 }
 
+uint16_t
+bd_gtk__ShowPanel(void)
+{
+	if(pWindow)		{ return kErr_Bsp_NoError; }
+
+	// initialize gtk lib. in this environment, no command line options are available.
+	if(!gtkready)	{ gtkready = (gtk_init_check(&argc, &argv) != 0); }
+	if(!gtkready)	{ return kErr_Board_NoPanel; }
+
+	return LoadPanel() ? kErr_Bsp_InitFailed : kErr_Bsp_NoError;
+}
+
+bool
+bd_gtk__Get_PanelShown(void)
+{
+	return pWindow != NULL;
+}
+
 bool
 Cwsw_Board__Get_Initialized(void)
 {
 	return initialized;
 }
 
+void
+bd_gtk__Wake(void)
+{
+	// inside the heartbeat (e.g. from a task), the source being dispatched re-arms itself on return;
+	// replacing it here would leave two sources running
+	if(hbdispatching)
+	{
+		hbwakepending = true;
+		return;
+	}
+
+	// already waking every tick, or not running yet: nothing to do
+	if(!hbsource || (hbperiod <= 1))	{ return; }
+
+	(void)g_source_remove(hbsource);
+	hbsource = 0;
+	(void)ArmHeartbeat(1);
+}
+
+tBoardTickStats
+Cwsw_Board__Get_TickStats(void)
+{
+	return tickstats;
+}
+
 // ---- /General Functions -------------------------------------------------- }
 
 // ---- Common API / Highly Customized -------------------------------------- {
@@ -181,42 +600,70 @@ Cwsw_Board__Get_Initialized(void)
 void
 Cwsw_Board__Set_kBoardLed1(bool value)
 {
-	GObject *pind = gtk_builder_get_object(pUiPanel, "ind0");	// run-time association w/ "ID" field in UI
-	if(pind)
-	{
-		gtk_toggle_button_set_active((GtkToggleButton *)pind, value);
-	}
+	SetLed(kBoardLed1, value);
 }
 
 void
 Cwsw_Board__Set_kBoardLed2(bool value)
 {
-	GObject *pind = gtk_builder_get_object(pUiPanel, "ind1");	// run-time association w/ "ID" field in UI
-	if(pind)
-	{
-		gtk_toggle_button_set_active((GtkToggleButton *)pind, value);
-	}
+	SetLed(kBoardLed2, value);
 }
 
 void
 Cwsw_Board__Set_kBoardLed3(bool value)
 {
-	GObject *pind = gtk_builder_get_object(pUiPanel, "ind2");	// run-time association w/ "ID" field in UI
-	if(pind)
-	{
-		gtk_toggle_button_set_active((GtkToggleButton *)pind, value);
-	}
+	SetLed(kBoardLed3, value);
 }
 
 void
 Cwsw_Board__Set_kBoardLed4(bool value)
 {
-	GObject *pind = gtk_builder_get_object(pUiPanel, "ind3");	// run-time association w/ "ID" field in UI
-	if(pind)
-	{
-		gtk_toggle_button_set_active((GtkToggleButton *)pind, value);
-	}
+	SetLed(kBoardLed4, value);
+}
+
+void
+Cwsw_Board__Set_LedMask(uint32_t mask)
+{
+	ledshadow = mask & ((1UL << kBoardNumLeds) - 1);
+	UpdateLeds();
+}
+
+uint32_t
+Cwsw_Board__Get_LedImage(void)
+{
+	return ledshadow;
+}
+
+#if (BOARD_DISPLAY)
+void
+Cwsw_Board__DisplayWrite(uint32_t row, uint32_t col, const char *text)
+{
+	if(di_display_write(&display, row, col, text, BOARD_DISPLAY_COLS))	{ ArmIdle(); }
+}
+
+void
+Cwsw_Board__DisplayClear(void)
+{
+	if(di_display_clear(&display))	{ ArmIdle(); }
+}
+
+struct sBoardDisplay const *
+Cwsw_Board__Get_Display(void)
+{
+	return &display;
+}
+#endif
+
+#if (BOARD_LED_PWM)
+void
+Cwsw_Board__SetLedDuty(uint32_t led, uint8_t duty)
+{
+	if(led >= kBoardNumLeds)	{ return; }
+	di_led_pwm_set(&ledpwm, led, duty);
+	UpdateLeds();
+	bd_gtk__Wake();		// in tickless idle, dimming needs the heartbeat every tick
 }
+#endif
 
 // ---- /Common API / Highly Customized ------------------------------------- }
 
@@ -0,0 +1,105 @@
+/** @file
+ *	@brief	Panel rheostats of the GTK board: the analog-input side of the simulated hardware.
+ *
+ *	Each rheostat is a GtkRange (a scale or slider) whose adjustment spans the ADC's counts; its
+ *	"value-changed" callback latches the new level, and the analog task's block read hands the
+ *	latched level out as every sample of the block. The callbacks and the heartbeat both run in the
+ *	GTK main loop, so nothing here needs locking.
+ *
+ *	\copyright
+ *	Copyright (c) 2026 agent. All rights reserved.
+ *
+ *	Created on: Oct 14, 2026
+ *	@author agent
+ */
+
+// ============================================================================
+// ----	Include Files ---------------------------------------------------------
+// ============================================================================
+
+// ----	System Headers --------------------------
+#include <stdbool.h>
+
+// ----	Project Headers -------------------------
+
+// ----	Module Headers --------------------------
+#include "cwsw_board.h"			/* pull in the GTK info */
+#include "cwsw_bsp_analog.h"	/* di_read_analog_block() */
+
+#if (BOARD_ANALOG)					/* { */
+
+// ============================================================================
+// ----	Constants -------------------------------------------------------------
+// ============================================================================
+
+/// Highest count the ADC reads.
+#define kAnalogFullScale	((1UL << BOARD_ANALOG_BITS) - 1)
+
+
+// ============================================================================
+// ----	Type Definitions ------------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Global Variables ------------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Module-level Variables ------------------------------------------------
+// ============================================================================
+
+static uint16_t analoginputs[kBoardNumAnalogs] = {0};	// level each rheostat was last set to
+
+
+// ============================================================================
+// ----	Private Functions -----------------------------------------------------
+// ============================================================================
+
+static void
+cbUiRheostatChanged(GtkRange *prange, gpointer data)
+{
+	gdouble value = gtk_range_get_value(prange);
+
+	if(value < 0)					{ value = 0; }
+	if(value > kAnalogFullScale)	{ value = kAnalogFullScale; }
+	bd_gtk__SetAnalog(GPOINTER_TO_UINT(data), (uint16_t)(value + 0.5));
+}
+
+
+// ============================================================================
+// ----	Public Functions ------------------------------------------------------
+// ============================================================================
+
+/** Wire one panel rheostat to analog channel `channel`, and take its current position.
+ *	@returns true on failure.
+ */
+bool
+di_analog_bind(GObject *prange, uint32_t channel)
+{
+	if(!prange)							{ return true; }
+	if(channel >= kBoardNumAnalogs)		{ return true; }
+
+	g_signal_connect(prange, "value-changed", G_CALLBACK(cbUiRheostatChanged), GUINT_TO_POINTER(channel));
+	cbUiRheostatChanged((GtkRange *)prange, GUINT_TO_POINTER(channel));
+	return false;
+}
+
+void
+bd_gtk__SetAnalog(uint32_t channel, uint16_t value)
+{
+	if(channel < kBoardNumAnalogs)	{ analoginputs[channel] = value; }
+}
+
+void
+di_read_analog_block(uint16_t *psamples, uint32_t count)
+{
+	uint32_t ch, idx;
+
+	if(!psamples)	{ return; }
+	for(ch = 0; ch < kBoardNumAnalogs; ++ch)
+	{
+		for(idx = 0; idx < count; ++idx)	{ *psamples++ = analoginputs[ch]; }
+	}
+}
+
+#endif											/* } */
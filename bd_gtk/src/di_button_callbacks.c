@@ -19,6 +19,8 @@
 
 // ----	Module Headers --------------------------
 #include "cwsw_board.h"	/* pull in the GTK info */
+#include "cwsw_bsp_edgering.h"	/* UI -> DI edge handoff */
+#include "cwsw_bsp_buttons.h"	/* Btn_Wake() */
 
 
 // ============================================================================
@@ -38,6 +40,12 @@
 #define cleanpatterna	0xFF9
 #define cleanpatternb	~cleanpatterna
 
+/// Length, in bits, of the clean press (or release) pattern.
+#define kCleanPatternBits	12
+
+/// Capacity, in bits, of one button's simulated input stream.
+#define kStreamBits			64
+
 
 // ============================================================================
 // ----	Type Definitions ------------------------------------------------------
@@ -51,29 +59,80 @@
 // ----	Module-level Variables ------------------------------------------------
 // ============================================================================
 
+/* The UI callbacks touch nothing below except the edge ring; everything else is owned by the DI
+ * reader, which turns drained edges into simulated input streams.
+ */
+static tBoardEdgeRing buttonedges = {0};
 static uint64_t buttoninputbits[kBoardNumButtons]	= {0};
-static uint32_t buttonstatus = 0;	// bitmapped image of current button state. 32 bits mostly to avoid compiler warnings.
-
-GObject *btn0		= NULL;
-GObject *btn1		= NULL;
-GObject *btn2		= NULL;
-GObject *btn3		= NULL;
-GObject *btn4		= NULL;
-GObject *btn5		= NULL;
-GObject *btn6		= NULL;
-GObject *btn7		= NULL;
+static uint8_t buttonstreamlen[kBoardNumButtons]	= {0};	// bits still queued in buttoninputbits[]
+static tBoardButtonMap buttonstatus[kBoardNumButtonWords]		= {0};	// bitmapped image of current button state
+static tBoardButtonMap buttonstreams[kBoardNumButtonWords]		= {0};	// inputs w/ simulated input bits still queued
+static tBoardButtonMap buttonactivity[kBoardNumButtonWords]	= {0};	// inputs that changed since the last scan
+#if (BOARD_BUTTON_EDGE_TIMES)
+static tBoardButtonMap buttonedgemask[kBoardNumButtonWords]	= {0};	// inputs w/ an edge time not yet read
+static tCwswClockTics buttonedgetime[kBoardNumButtons]		= {0};	// time the UI saw each input's last edge
+#endif
 
 /** Event queue to which button events will be posted.
  *	Nothing (at the moment) in this module directly uses this variable, but this button component
  *	"owns" the queue, and it is shared to the components (such as the SME) that need to post.
  */
-tEvQ_QueueCtrlEx BtnQ = NULL;
+ptEvQ_QueueCtrlEx BtnQ = NULL;
 
 
 // ============================================================================
 // ----	Private Functions -----------------------------------------------------
 // ============================================================================
 
+static bool
+di_read_next_button_input_bit(uint32_t idx)
+{
+	bool retval;
+	if(!buttonstreamlen[idx])	// once the input stream is depleted, the "button pressed" flag is the input
+	{
+		// toggle buttons didn't work as i wanted - each press also gets a release, but it's a press-release sandwich where the "pressed" status is the meat
+		return BTNMAP_TEST(buttonstatus, idx);
+	}
+	retval = ((buttoninputbits[idx] & 1) != 0);
+	buttoninputbits[idx] /= 2;
+	--buttonstreamlen[idx];
+	return retval;
+}
+
+/** Move edges from the UI's ring into the simulated input streams.
+ *	Each edge appends one clean pattern behind whatever is still queued for that button. If the
+ *	stream has no room (clicks faster than the debounce can resolve anyway), the pattern is dropped
+ *	but the level is kept, so the button still settles to the last edge the UI saw.
+ */
+static void
+di_drain_button_edges(void)
+{
+	tBoardEdge edge;
+
+	while(di_edge_peek(&buttonedges, &edge))
+	{
+		uint32_t idx = edge.button;
+		if((idx > kBoardButtonNone) && (idx < kBoardNumButtons))
+		{
+			if(buttonstreamlen[idx] + kCleanPatternBits <= kStreamBits)
+			{
+				uint64_t pattern = edge.level ? cleanpatterna : (cleanpatternb & 0xFFF);
+				buttoninputbits[idx] |= (pattern << buttonstreamlen[idx]);
+				buttonstreamlen[idx] += kCleanPatternBits;
+			}
+			if(edge.level)	{ BTNMAP_SET(buttonstatus, idx); }
+			else			{ BTNMAP_CLR(buttonstatus, idx); }
+			BTNMAP_SET(buttonstreams, idx);
+			BTNMAP_SET(buttonactivity, idx);
+#if (BOARD_BUTTON_EDGE_TIMES)
+			BTNMAP_SET(buttonedgemask, idx);
+			buttonedgetime[idx] = edge.tm;
+#endif
+		}
+		di_edge_pop(&buttonedges);
+	}
+}
+
 // ============================================================================
 // ----	Public Functions ------------------------------------------------------
 // ============================================================================
@@ -82,13 +141,13 @@ tEvQ_QueueCtrlEx BtnQ = NULL;
  * and show the CWSW BSP, and as such, i need to translate GTK events into things the BSP under-
  * stands.
  *
- * for simpleness, each event and each button has its own callback, which then set flags as
- * appropriate for the CWSW code to process.
+ * for simpleness, each event has its own callback, shared by all buttons, which then hands the
+ * edge on for the CWSW code to process.
  */
 
 /* on a physical board, my DI task will read all inputs at once, and will iterate through the
  * handlers for the individual assignments. to kinda-sorta replicate that behavior, we'll have one
- * button handler, and will detect which button was pressed by the widget address.
+ * button handler, and each widget carries its button ID as the signal's user data.
  *
  * note that on a real board, the DI action would be descended from a task, not a dispatched event
  * from the GUI framework.
@@ -106,82 +165,24 @@ cbButtonClicked(GtkWidget *widget, gpointer data)
 void
 cbUiButtonPressed(GtkWidget *widget, gpointer data)
 {
-	uint32_t idx = kBoardButtonNone;
-	UNUSED(data);
-
-	// this layer knows about button assignments. for now, only the 1st 4 buttons are assigned.
-	//	we're a bit inverted here, in that the GUI is hooked to this layer, but in a real board, the
-	//	lower layers know which button is pressed and feed that info back up here.
-	// 'twould rather use a switch statement, but can't b/c GCC complains about a pointer not being a scalar type
-	if(widget == (GtkWidget *)btn0) { idx = kBoardButton0; } else
-	if(widget == (GtkWidget *)btn1) { idx = kBoardButton1; } else
-	if(widget == (GtkWidget *)btn2) { idx = kBoardButton2; } else
-	if(widget == (GtkWidget *)btn3) { idx = kBoardButton3; } else
-	if(widget == (GtkWidget *)btn4) { idx = kBoardButton4; } else
-	if(widget == (GtkWidget *)btn5) { idx = kBoardButton5; } else
-	if(widget == (GtkWidget *)btn6) { idx = kBoardButton6; } else
-	if(widget == (GtkWidget *)btn7) { idx = kBoardButton7; } else
-	{
-		// empty final else clause
-	}
+	UNUSED(widget);
 
-	// toggle back and forth between two noisy sets of inputs.
-	// - the 1st is 64 bits of noise, the tail of which is 8 "on" bits (hence a debounced button press).
-	// - the 2nd intentionally fails qualification for a button press; remember that this function
-	//	"sets" the pressed indicator, we we have to book-end the embedded 0 bits with "1" markers to
-	// make the detection algorithms work.
+	// this layer knows about button assignments: the board's wiring table bound this widget to
+	//	a button ID. we're a bit inverted here, in that the GUI is hooked to this layer, but in a
+	//	real board, the lower layers know which button is pressed and feed that info back up here.
 
-	// call into the next layer down (arch)
-	// for exploration, we'll use 8 consecutive bits of the same value to detect a state change
-#if 0
-	static bool noisypattern = false;	// location here in this function requires C99, prohibits Visual Studio
-	buttoninputbits[idx] = noisypattern ? noisypatterna : noisypatternb; noisypattern = !noisypattern;
-#else
-	if(buttoninputbits[idx])
-	{
-		buttoninputbits[idx] += cleanpatterna * 4096; // clean pattern is 12 bits
-	}
-	else
-	{
-		buttoninputbits[idx] = cleanpatterna;
-	}
-#endif
-	BIT_SET(buttonstatus, idx);
+	// call into the next layer down (arch). the DI reader turns the edge into a clean, 12-bit
+	// pattern; 8 consecutive bits of the same value are what the debounce needs to see.
+	(void)bd_gtk__PushButton((uint16_t)GPOINTER_TO_UINT(data), true);
 }
 
 void
 cbUiButtonReleased(GtkWidget *widget, gpointer data)
 {
-	uint32_t idx = 0;
-	UNUSED(data);
-	// 'twould rather use a switch statement, but can't b/c GCC complains about a pointer not be a scalar type
-	if(widget == (GtkWidget *)btn0) { idx = kBoardButton0; } else
-	if(widget == (GtkWidget *)btn1) { idx = kBoardButton1; } else
-	if(widget == (GtkWidget *)btn2) { idx = kBoardButton2; } else
-	if(widget == (GtkWidget *)btn3) { idx = kBoardButton3; } else
-	if(widget == (GtkWidget *)btn4) { idx = kBoardButton4; } else
-	if(widget == (GtkWidget *)btn5) { idx = kBoardButton5; } else
-	if(widget == (GtkWidget *)btn6) { idx = kBoardButton6; } else
-	if(widget == (GtkWidget *)btn7) { idx = kBoardButton7; } else
-	{
-		// empty final else clause
-	}
+	UNUSED(widget);
 
 	// call into the next layer down (arch)
-#if 0
-	static bool noisypattern = false;	// location here in this function requires C99, prohibits Visual Studio
-	buttoninputbits[idx] = noisypattern ? noisypatternb : noisypatterna; noisypattern = !noisypattern;
-#else
-	if(buttoninputbits[idx])
-	{
-		buttoninputbits[idx] += (uint64_t)((cleanpatternb & 0xFFF) * 4096);
-	}
-	else
-	{
-		buttoninputbits[idx] = (uint64_t)((cleanpatternb & 0xFFF));
-	}
-#endif
-	BIT_CLR(buttonstatus, idx);
+	(void)bd_gtk__PushButton((uint16_t)GPOINTER_TO_UINT(data), false);
 
 	/* running commentaire, to be moved to more formal documentation.
 	 * - if the DI button SM is in the "released" state, the 1st 1 bit will provoke a transition to
@@ -193,101 +194,107 @@ cbUiButtonReleased(GtkWidget *widget, gpointer data)
 
 
 bool
-di_read_next_button_input_bit(uint32_t idx)
+bd_gtk__PushButton(uint16_t button, bool pressed)
 {
-	bool retval = ((buttoninputbits[idx] & 1) != 0);
-	buttoninputbits[idx] /= 2;
-	if((!retval) && (!buttoninputbits[idx]))	// if this bit is clear, it could be because the input stream is depleted; if the input stream is also depleted...
-	{	// ... then check whether the "button pressed" flag is true
-		// toggle buttons didn't work as i wanted - each press also gets a release, but it's a press-release sandwich where the "pressed" status is the meat
-//		retval = gtk_toggle_button_get_active((GtkToggleButton *)btn0);	// todo: return state of last button pressed
-		retval = BIT_TEST(buttonstatus, idx);
-	}
-	return retval;
+	bool pushed = di_edge_push(&buttonedges, button, pressed);
+	bd_gtk__Wake();		// the heartbeat, once awake, wakes the button scan; see di_button_wake()
+	return pushed;
 }
 
-bool
-di_button_init(GtkBuilder *pUiPanel, ptEvQ_QueueCtrlEx pEvQX)
+/** Scheduler side: bring an idle button scan back to its fast rate if the UI has queued edges.
+ *	Called from the heartbeat, on the thread that runs the button task, before the ticks that are
+ *	due; the UI callbacks only push edges, and never touch the scan alarm themselves.
+ */
+void
+di_button_wake(void)
 {
-	bool bad_init = false;
-
-	/* we want button-press and button-release events. for convenience and exploration, we'll also
-	 * capture the click event.
-	 */
-	btn0 = gtk_builder_get_object(pUiPanel, "btn0");// run-time association w/ "ID" field in UI
-	if(!btn0)	{ bad_init = true; }
+	if(di_edge_pending(&buttonedges))	{ Btn_Wake(); }
+}
 
-	if(!bad_init)		// connect btn0, get handle for button 1
-	{
-		g_signal_connect(btn0, "clicked",	G_CALLBACK(cbButtonClicked), NULL);
-		g_signal_connect(btn0, "pressed",	G_CALLBACK(cbUiButtonPressed), NULL);
-		g_signal_connect(btn0, "released",	G_CALLBACK(cbUiButtonReleased), NULL);
 
-		btn1 = gtk_builder_get_object(pUiPanel, "btn1");
-		if(!btn1)	{ bad_init = true; }
-	}
+void
+di_read_button_inputs(tBoardButtonMap *pinputs)
+{
+	uint32_t idx;
 
-	if(!bad_init)		// connect btn1, get handle for button 2
-	{
-		g_signal_connect(btn1, "clicked", G_CALLBACK(cbButtonClicked), NULL);
-		g_signal_connect(btn1, "clicked", G_CALLBACK(cbUiButtonPressed), NULL);
-		g_signal_connect(btn1, "clicked", G_CALLBACK(cbUiButtonReleased), NULL);
+	if(!pinputs)	{ return; }
+	di_drain_button_edges();
 
-		btn2 = gtk_builder_get_object(pUiPanel, "btn2");
-		if(!btn2)	{ bad_init = true; }
-	}
+	// idle inputs simply read their current level
+	for(idx = 0; idx < kBoardNumButtonWords; ++idx)	{ pinputs[idx] = buttonstatus[idx]; }
 
-	if(!bad_init)		// connect btn2, get handle for button 3
+	// the simulated inputs are per-button bit streams; advance only those w/ bits left in them.
+	for(idx = 0; idx < kBoardNumButtons; ++idx)
 	{
-		g_signal_connect(btn2, "clicked", G_CALLBACK(cbButtonClicked), NULL);
-		g_signal_connect(btn2, "clicked", G_CALLBACK(cbUiButtonPressed), NULL);
-		g_signal_connect(btn2, "clicked", G_CALLBACK(cbUiButtonReleased), NULL);
-
-		btn3 = gtk_builder_get_object(pUiPanel, "btn3");
-		if(!btn3)	{ bad_init = true; }
+		if(!buttonstreams[idx / BOARD_BUTTON_MAP_WORD_BITS])
+		{
+			idx |= BOARD_BUTTON_MAP_WORD_BITS - 1;		// nothing queued in this word; skip to the next
+			continue;
+		}
+		if(!BTNMAP_TEST(buttonstreams, idx))		{ continue; }
+
+		if(di_read_next_button_input_bit(idx))		{ BTNMAP_SET(pinputs, idx); }
+		else										{ BTNMAP_CLR(pinputs, idx); }
+		if(!buttonstreamlen[idx])					{ BTNMAP_CLR(buttonstreams, idx); }
 	}
+}
 
-	if(!bad_init)		// connect btn3, get handle for button 4
-	{
-		g_signal_connect(btn3, "clicked", G_CALLBACK(cbButtonClicked), NULL);
-		g_signal_connect(btn3, "clicked", G_CALLBACK(cbUiButtonPressed), NULL);
-		g_signal_connect(btn3, "clicked", G_CALLBACK(cbUiButtonReleased), NULL);
+void
+di_read_button_activity(tBoardButtonMap *pactivity)
+{
+	uint32_t idx;
 
-		btn4 = gtk_builder_get_object(pUiPanel, "btn4");
-		if(!btn4)	{ bad_init = true; }
+	if(!pactivity)	{ return; }
+	di_drain_button_edges();
+	for(idx = 0; idx < kBoardNumButtonWords; ++idx)
+	{
+		pactivity[idx] = buttonactivity[idx];
+		buttonactivity[idx] = 0;
 	}
+}
 
-	if(!bad_init)		// connect btn4, get handle for button 5
-	{
-		g_signal_connect(btn4, "clicked", G_CALLBACK(cbButtonClicked), NULL);
-		g_signal_connect(btn4, "clicked", G_CALLBACK(cbUiButtonPressed), NULL);
-		g_signal_connect(btn4, "clicked", G_CALLBACK(cbUiButtonReleased), NULL);
+#if (BOARD_BUTTON_EDGE_TIMES)
+void
+di_read_button_edge_times(tBoardButtonMap *pedges, tCwswClockTics *ptimes)
+{
+	uint32_t idx;
 
-		btn5 = gtk_builder_get_object(pUiPanel, "btn5");
-		if(!btn5)	{ bad_init = true; }
+	if(!pedges || !ptimes)	{ return; }
+	di_drain_button_edges();
+	for(idx = 0; idx < kBoardNumButtonWords; ++idx)
+	{
+		pedges[idx] = buttonedgemask[idx];
+		buttonedgemask[idx] = 0;
 	}
-
-	if(!bad_init)		// connect btn5, get handle for button 6
+	for(idx = 0; idx < kBoardNumButtons; ++idx)
 	{
-		g_signal_connect(btn5, "clicked", G_CALLBACK(cbButtonClicked), NULL);
-		g_signal_connect(btn5, "clicked", G_CALLBACK(cbUiButtonPressed), NULL);
-		g_signal_connect(btn5, "clicked", G_CALLBACK(cbUiButtonReleased), NULL);
-
-		btn6 = gtk_builder_get_object(pUiPanel, "btn6");
-		if(!btn6)	{ bad_init = true; }
+		if(BTNMAP_TEST(pedges, idx))	{ ptimes[idx] = buttonedgetime[idx]; }
 	}
+}
+#endif
 
-	if(!bad_init)		// connect btn6, get handle for button 7
-	{
-		g_signal_connect(btn6, "clicked", G_CALLBACK(cbButtonClicked), NULL);
-		g_signal_connect(btn6, "clicked", G_CALLBACK(cbUiButtonPressed), NULL);
-		g_signal_connect(btn6, "clicked", G_CALLBACK(cbUiButtonReleased), NULL);
+/** Connect one panel widget to a button ID.
+ *	Called by the board's wiring table, once per button; the button ID rides along as the signal's
+ *	user data, so the callbacks need no lookup.
+ */
+bool
+di_button_bind(GObject *pbtn, uint32_t button)
+{
+	if(!pbtn)														{ return true; }
+	if((button <= kBoardButtonNone) || (button >= kBoardNumButtons))	{ return true; }
 
-		btn7 = gtk_builder_get_object(pUiPanel, "btn7");
-		if(!btn7)	{ bad_init = true; }
-	}
+	/* we want button-press and button-release events. for convenience and exploration, we'll also
+	 * capture the click event.
+	 */
+	g_signal_connect(pbtn, "clicked",	G_CALLBACK(cbButtonClicked), NULL);
+	g_signal_connect(pbtn, "pressed",	G_CALLBACK(cbUiButtonPressed), GUINT_TO_POINTER(button));
+	g_signal_connect(pbtn, "released",	G_CALLBACK(cbUiButtonReleased), GUINT_TO_POINTER(button));
+	return false;
+}
 
+bool
+di_button_init(ptEvQ_QueueCtrlEx pEvQX)
+{
 	BtnQ = pEvQX;
-
-	return bad_init;
+	return false;
 }
@@ -39,6 +39,16 @@ extern "C" {
 // ----	Constants -------------------------------------------------------------
 // ============================================================================
 
+#if (BOARD_BUTTONS_MATRIX)
+#error "the CVI panel (cwsw_board_ui.h) has no keypad matrix; build this board w/ BOARD_BUTTONS_MATRIX 0"
+#endif
+#if (BOARD_ANALOG)
+#error "the CVI panel (cwsw_board_ui.h) has no rheostats; build this board w/ BOARD_ANALOG 0"
+#endif
+#if (BOARD_DISPLAY)
+#error "the CVI panel (cwsw_board_ui.h) has no text display; build this board w/ BOARD_DISPLAY 0"
+#endif
+
 /** Button IDs for this board. */
 enum eBoardButtons
 {
@@ -64,6 +74,15 @@ enum eBoardLeds
 // ----	Type Definitions ------------------------------------------------------
 // ============================================================================
 
+/// Heartbeat (1 ms tick) statistics; see `Get(Cwsw_Board, TickStats)`.
+typedef struct sBoardTickStats {
+	uint32_t	ticks;			//!< ticks delivered since init
+	uint32_t	catchup;		//!< of those, ticks delivered back-to-back because the panel timer was late
+	uint32_t	latewakeups;	//!< timer events that found more than one tick due
+	uint32_t	skipped;		//!< ticks abandoned after falling more than BOARD_TICK_MAX_CATCHUP behind
+	uint32_t	maxlate_us;		//!< worst lateness of a timer event, in microseconds
+} tBoardTickStats;
+
 // ============================================================================
 // ----	Public Variables ------------------------------------------------------
 // ============================================================================
@@ -77,6 +96,8 @@ extern tCwswSwAlarm	Btn_tmr_ButtonRead;
 
 // ---- Discrete Functions -------------------------------------------------- {
 extern void		Btn_tsk_ButtonRead(tEvQ_Event ev, uint32_t extra);
+
+/** Queue the heartbeat hands to `tedlos_schedule()` on every tick. */
 extern void		Cwsw_Board__StartScheduler(ptEvQ_QueueCtrlEx pEvqx);
 
 // ---- /Discrete Functions ------------------------------------------------- }
@@ -105,6 +126,12 @@ extern void Cwsw_Board__Set_kBoardLed3(bool value);
 extern void Cwsw_Board__Set_kBoardLed4(bool value);
 /**	@} */
 
+/** Target for `Get(Cwsw_Board, TickStats)`.
+ *	Snapshot of the heartbeat's timing statistics. A tick is never lost silently: it is delivered
+ *	on time, delivered late (`catchup`), or counted in `skipped`.
+ */
+extern tBoardTickStats Cwsw_Board__Get_TickStats(void);
+
 // ---- /Targets for Get/Set APIs ------------------------------------------- }
 
 
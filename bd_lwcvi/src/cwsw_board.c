@@ -14,12 +14,15 @@
 
 // ----	System Headers --------------------------
 #include <stdbool.h>
+#include <utility.h>		// Timer()
 
 // ----	Project Headers -------------------------
 #include "cwsw_arch.h"		// Get(Iniitalized)
 
 // ----	Module Headers --------------------------
 #include "cwsw_board.h"
+#include "cwsw_bsp_buttons.h"		/* Btn_SetEventQueue() */
+#include "cwsw_bsp_ledpwm.h"		/* di_led_pwm_apply() */
 
 #include "ManagedAlarms.h"	// temporary until i get architecture sorted out. the BSP should not know about
 #include "tedlosevents.h"
@@ -29,10 +32,36 @@
 // ----	Constants -------------------------------------------------------------
 // ========================================================================== {
 
+/// Scheduler tick, in seconds of CVI's Timer() clock.
+#define kTickPeriodS		0.001
+
+#if !defined(BOARD_TICK_MAX_CATCHUP)
+/** Most ticks delivered back-to-back when the panel timer was late.
+ *	Beyond this (e.g., the process was stopped in a debugger), the heartbeat gives up on the
+ *	missed ticks, counts them as skipped, and re-synchronizes to "now".
+ */
+#define BOARD_TICK_MAX_CATCHUP	50
+#endif
+
+/// Kinds of panel control the board binds to.
+enum eUiBindKind {
+	kUiBindButton,
+	kUiBindLed
+};
+
+
 // ========================================================================== }
 // ----	Type Definitions ------------------------------------------------------
 // ========================================================================== {
 
+/// One row of the board's wiring: which panel control simulates which button or LED.
+typedef struct sUiBinding {
+	int			control;	//!< control ID, from the UIR include file
+	uint8_t		kind;		//!< #eUiBindKind
+	uint8_t		index;		//!< button ID (#eBoardButtons) or LED ID (#eBoardLeds)
+	int			oncolor;	//!< LED "on" color; unused for buttons
+} tUiBinding;
+
 // ========================================================================== }
 // ----	Global Variables ------------------------------------------------------
 // ========================================================================== {
@@ -45,24 +74,140 @@ static bool initialized = false;
 
 ptEvQ_QueueCtrlEx pOsEvqx = NULL;
 
-int hndPanel = NULL;
+int hndPanel = 0;
+
+/// The board's wiring. Adding a button or LED to the panel is one row here.
+static const tUiBinding uibindings[] = {
+	{ PANEL_btnGo,	kUiBindButton,	kBoardButton0,	0 },
+	{ PANEL_btn1,	kUiBindButton,	kBoardButton1,	0 },
+	{ PANEL_btn2,	kUiBindButton,	kBoardButton2,	0 },
+	{ PANEL_btn3,	kUiBindButton,	kBoardButton3,	0 },
+	{ PANEL_Green,	kUiBindLed,		kBoardLed1,		VAL_GREEN },
+	{ PANEL_Yellow,	kUiBindLed,		kBoardLed2,		VAL_YELLOW },
+	{ PANEL_Red,	kUiBindLed,		kBoardLed3,		VAL_RED },
+	{ PANEL_Walk,	kUiBindLed,		kBoardLed4,		VAL_GREEN },
+};
+
+/* LED writes land in the shadow image and set a dirty bit; the heartbeat pushes only the dirty
+ * indicators to the panel, once per timer event, so a fast-blinking task costs one redraw per
+ * event rather than one per write. W/ dimming, the heartbeat also re-evaluates the output image
+ * on every timer event.
+ */
+static int ledcontrols[kBoardNumLeds] = {0};	//!< control ID of each LED, filled from the wiring table at init
+static uint32_t ledshadow	= 0;		//!< bitmapped LED image, as last written by the application
+static uint32_t ledoutput	= 0;		//!< what the indicators should show: the shadow, after dimming
+static uint32_t leddirty	= 0;		//!< LEDs whose output differs from what the panel is showing
+#if (BOARD_LED_PWM)
+static tBoardLedPwm ledpwm	= {0};
+#endif
+
+/* EVENT_TIMER_TICKs arrive late, or not at all, while the panel is busy (redraws, window drags).
+ * The heartbeat keeps its own schedule on Timer() and, on each timer event, delivers every tick
+ * that has come due since the last one.
+ */
+static double tmNextTick			= 0.0;		//!< Timer() time at which the next tick is due
+static tBoardTickStats tickstats	= {0};
 
 
 // ========================================================================== }
 // ----	Private Functions -----------------------------------------------------
 // ========================================================================== {
 
+/// Push the indicators that changed since the last flush to the panel.
+static void
+FlushLeds(void)
+{
+	uint32_t led;
+	for(led = 0; leddirty && (led < kBoardNumLeds); ++led)
+	{
+		if(!BIT_TEST(leddirty, led))	{ continue; }
+		// a failed write stays dirty, and is retried on the next flush
+		if(!ledcontrols[led] || (SetCtrlVal(hndPanel, ledcontrols[led], BIT_TEST(ledoutput, led) ? 1 : 0) >= 0))
+		{
+			BIT_CLR(leddirty, led);
+		}
+	}
+}
+
+/// Work out this tick's output image, and mark the indicators it changes as dirty.
+static void
+UpdateLeds(void)
+{
+#if (BOARD_LED_PWM)
+	uint32_t out = di_led_pwm_apply(&ledpwm, ledshadow, Get(Cwsw_Clock, Now));
+#else
+	uint32_t out = ledshadow;
+#endif
+
+	leddirty |= out ^ ledoutput;
+	ledoutput = out;
+}
+
+/// Record an LED write in the shadow image; a write that doesn't change the value is a no-op.
+static void
+SetLed(uint32_t led, bool value)
+{
+	if(led >= kBoardNumLeds)	{ return; }
+	if(value)	{ BIT_SET(ledshadow, led); }
+	else		{ BIT_CLR(ledshadow, led); }
+	UpdateLeds();
+}
+
 // ========================================================================== }
 // ----	Public Functions ------------------------------------------------------
 // ========================================================================== {
 
+/** Panel timer callback.
+ *	Each EVENT_TIMER_TICK runs the scheduler once for every 1 ms tick that has come due, so the
+ *	CWSW clock keeps pace even when the panel's timer events are late or coalesced; then the LEDs
+ *	written during those ticks are drawn, once.
+ */
 int CVICALLBACK
 tmHeartbeat(int panel, int control, int event, void *callbackData, int eventData1, int eventData2)
 {
+	extern void di_button_wake(void);
+	double now, late;
+	uint32_t due;
+	UNUSED(panel);
+	UNUSED(control);
+	UNUSED(callbackData);
+	UNUSED(eventData1);
+	UNUSED(eventData2);
+
 	switch (event)
 	{
 	case EVENT_TIMER_TICK:
-		tedlos_schedule(pOsEvqx);
+		now = Timer();
+		if(now < tmNextTick)	{ break; }		// early; nothing due yet
+
+		late = now - tmNextTick;
+		due = (uint32_t)(late / kTickPeriodS) + 1;
+		if(late * 1e6 > (double)tickstats.maxlate_us)
+		{
+			tickstats.maxlate_us = (late * 1e6 < (double)UINT32_MAX) ? (uint32_t)(late * 1e6) : UINT32_MAX;
+		}
+		if(due > 1)		{ ++tickstats.latewakeups; }
+
+		if(due > BOARD_TICK_MAX_CATCHUP + 1)
+		{
+			// re-sync: give up on the oldest missed ticks
+			tickstats.skipped += due - (BOARD_TICK_MAX_CATCHUP + 1);
+			tmNextTick += (double)(due - (BOARD_TICK_MAX_CATCHUP + 1)) * kTickPeriodS;
+			due = BOARD_TICK_MAX_CATCHUP + 1;
+		}
+		tickstats.catchup += due - 1;
+
+		di_button_wake();		// UI edges wake an idle button scan from here, not from the UI callbacks
+		while(due--)
+		{
+			tedlos_schedule(pOsEvqx);
+			++tickstats.ticks;
+			tmNextTick += kTickPeriodS;
+		}
+#if (BOARD_LED_PWM)
+		UpdateLeds();
+#endif
+		FlushLeds();
 		break;
 
 	default:
@@ -74,9 +219,11 @@ tmHeartbeat(int panel, int control, int event, void *callbackData, int eventData
 
 // ---- General Functions --------------------------------------------------- {
 uint16_t
-Cwsw_Board__Init(void)
+Cwsw_Board__Init(ptEvQ_QueueCtrlEx pEvQX)
 {
+	extern int CVICALLBACK cbUiButton(int panel, int control, int event, void *callbackData, int eventData1, int eventData2);
 	int initrc = 0;
+	uint32_t row;
 	if(!Get(Cwsw_Arch, Initialized))
 	{
 		return kErr_Lib_NotInitialized;
@@ -87,22 +234,43 @@ Cwsw_Board__Init(void)
 	hndPanel = LoadPanel (0, "board.uir", PANEL);
 	if(hndPanel < 0)				{ return kErr_Board_NoPanel; }
 
-	if(initrc >= 0)	initrc = SetCtrlAttribute(hndPanel, PANEL_Green, ATTR_OFF_COLOR, VAL_GRAY);
-	if(initrc >= 0)	initrc = SetCtrlAttribute(hndPanel, PANEL_Yellow, ATTR_OFF_COLOR, VAL_GRAY);
-	if(initrc >= 0)	initrc = SetCtrlAttribute(hndPanel, PANEL_Red, ATTR_OFF_COLOR, VAL_GRAY);
-	if(initrc >= 0)	initrc = SetCtrlAttribute(hndPanel, PANEL_Walk, ATTR_OFF_COLOR, VAL_GRAY);
-
-	if(initrc >= 0)	initrc = SetCtrlAttribute(hndPanel, PANEL_Green, ATTR_ON_COLOR, VAL_GREEN);
-	if(initrc >= 0)	initrc = SetCtrlAttribute(hndPanel, PANEL_Yellow, ATTR_ON_COLOR, VAL_YELLOW);
-	if(initrc >= 0)	initrc = SetCtrlAttribute(hndPanel, PANEL_Red, ATTR_ON_COLOR, VAL_RED);
-	if(initrc >= 0)	initrc = SetCtrlAttribute(hndPanel, PANEL_Walk, ATTR_ON_COLOR, VAL_GREEN);
+	for(row = 0; (initrc >= 0) && (row < TABLE_SIZE(uibindings)); ++row)
+	{
+		const tUiBinding *pbind = &uibindings[row];
+		switch(pbind->kind)
+		{
+		case kUiBindButton:
+			// every button shares one callback; the button ID rides along as callback data, so
+			//	the callback needs no lookup. this overrides whatever callback the UIR names.
+			initrc = InstallCtrlCallback(hndPanel, pbind->control, cbUiButton, (void *)(uintptr_t)pbind->index);
+			break;
+
+		case kUiBindLed:
+			if(pbind->index < kBoardNumLeds)	{ ledcontrols[pbind->index] = pbind->control; }
+			if(initrc >= 0)	initrc = SetCtrlAttribute(hndPanel, pbind->control, ATTR_OFF_COLOR, VAL_GRAY);
+			if(initrc >= 0)	initrc = SetCtrlAttribute(hndPanel, pbind->control, ATTR_ON_COLOR, pbind->oncolor);
+			break;
+
+		default:
+			break;
+		}
+	}
 
 	if(initrc >= 0)	initrc = DisplayPanel(hndPanel);
+	if(initrc < 0)
+	{
+		DiscardPanel(hndPanel);
+		hndPanel = 0;
+		return kErr_Bsp_InitFailed;
+	}
 
-	SET(kBoardLed1, kLogicalOff);
-	SET(kBoardLed2, kLogicalOff);
-	SET(kBoardLed3, kLogicalOff);
-	SET(kBoardLed4, kLogicalOff);
+	// debounced button notifications go to the queue the board was given
+	Btn_SetEventQueue(pEvQX);
+
+	// the panel's initial indicator states are whatever the UIR says; force the 1st flush.
+	leddirty = (1UL << kBoardNumLeds) - 1;
+	tmNextTick = Timer() + kTickPeriodS;
+	Set(Cwsw_Board, LedMask, 0);
 
 	initialized = true;
 	return kErr_Bsp_NoError;
@@ -114,6 +282,18 @@ Cwsw_Board__Get_Initialized(void)
 	return initialized;
 }
 
+void
+Cwsw_Board__StartScheduler(ptEvQ_QueueCtrlEx pEvqx)
+{
+	pOsEvqx = pEvqx;
+}
+
+tBoardTickStats
+Cwsw_Board__Get_TickStats(void)
+{
+	return tickstats;
+}
+
 // ---- /General Functions -------------------------------------------------- }
 
 // ---- Common API / Highly Customized -------------------------------------- {
@@ -121,27 +301,49 @@ Cwsw_Board__Get_Initialized(void)
 void
 Cwsw_Board__Set_kBoardLed1(bool value)
 {
-	int a = SetCtrlVal(hndPanel, PANEL_Green, value);
-
+	SetLed(kBoardLed1, value);
 }
 
 void
 Cwsw_Board__Set_kBoardLed2(bool value)
 {
-	int a = SetCtrlVal(hndPanel, PANEL_Yellow, value);
+	SetLed(kBoardLed2, value);
 }
 
 void
 Cwsw_Board__Set_kBoardLed3(bool value)
 {
-	int a = SetCtrlVal(hndPanel, PANEL_Red, value);
+	SetLed(kBoardLed3, value);
 }
 
 void
 Cwsw_Board__Set_kBoardLed4(bool value)
 {
-	int a = SetCtrlVal(hndPanel, PANEL_Walk, value);
+	SetLed(kBoardLed4, value);
+}
+
+void
+Cwsw_Board__Set_LedMask(uint32_t mask)
+{
+	ledshadow = mask & ((1UL << kBoardNumLeds) - 1);
+	UpdateLeds();
+}
+
+uint32_t
+Cwsw_Board__Get_LedImage(void)
+{
+	return ledshadow;
+}
+
+#if (BOARD_LED_PWM)
+void
+Cwsw_Board__SetLedDuty(uint32_t led, uint8_t duty)
+{
+	if(led >= kBoardNumLeds)	{ return; }
+	di_led_pwm_set(&ledpwm, led, duty);
+	UpdateLeds();
 }
+#endif
 
 // ---- /Common API / Highly Customized ------------------------------------- }
 
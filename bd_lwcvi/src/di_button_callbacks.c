@@ -18,6 +18,8 @@
 
 // ----	Module Headers --------------------------
 #include "cwsw_board.h"	/* pull in the GTK info */
+#include "cwsw_bsp_edgering.h"	/* UI -> DI edge handoff */
+#include "cwsw_bsp_buttons.h"	/* Btn_Wake() */
 
 
 // ============================================================================
@@ -37,6 +39,12 @@
 #define cleanpatterna	0xFF9
 #define cleanpatternb	~cleanpatterna
 
+/// Length, in bits, of the clean press (or release) pattern.
+#define kCleanPatternBits	12
+
+/// Capacity, in bits, of one button's simulated input stream.
+#define kStreamBits			32
+
 
 // ============================================================================
 // ----	Type Definitions ------------------------------------------------------
@@ -50,47 +58,172 @@
 // ----	Module-level Variables ------------------------------------------------
 // ============================================================================
 
+/* The UI callbacks touch nothing below except the edge ring; everything else is owned by the DI
+ * reader, which turns drained edges into simulated input streams.
+ */
+static tBoardEdgeRing buttonedges = {0};
 static uint32_t buttoninputbits[kBoardNumButtons]	= {0};
-static uint32_t buttonstatus = 0;	// bitmapped image of current button state. 32 bits mostly to avoid compiler warnings.
+static uint8_t buttonstreamlen[kBoardNumButtons]	= {0};	// bits still queued in buttoninputbits[]
+static tBoardButtonMap buttonstatus[kBoardNumButtonWords]		= {0};	// bitmapped image of current button state
+static tBoardButtonMap buttonstreams[kBoardNumButtonWords]		= {0};	// inputs w/ simulated input bits still queued
+static tBoardButtonMap buttonactivity[kBoardNumButtonWords]	= {0};	// inputs that changed since the last scan
+#if (BOARD_BUTTON_EDGE_TIMES)
+static tBoardButtonMap buttonedgemask[kBoardNumButtonWords]	= {0};	// inputs w/ an edge time not yet read
+static tCwswClockTics buttonedgetime[kBoardNumButtons]		= {0};	// time the UI saw each input's last edge
+#endif
 
 
 // ============================================================================
 // ----	Private Functions -----------------------------------------------------
 // ============================================================================
 
+static bool
+di_read_next_button_input_bit(uint32_t idx)
+{
+	bool retval;
+	if(!buttonstreamlen[idx])	// once the input stream is depleted, the "button pressed" flag is the input
+	{
+		return BTNMAP_TEST(buttonstatus, idx);
+	}
+	retval = ((buttoninputbits[idx] & 1) != 0);
+	buttoninputbits[idx] /= 2;
+	--buttonstreamlen[idx];
+	return retval;
+}
+
+/** Move edges from the UI's ring into the simulated input streams.
+ *	Each edge appends one clean pattern behind whatever is still queued for that button. If the
+ *	stream has no room (clicks faster than the debounce can resolve anyway), the pattern is dropped
+ *	but the level is kept, so the button still settles to the last edge the UI saw.
+ */
+static void
+di_drain_button_edges(void)
+{
+	tBoardEdge edge;
+
+	while(di_edge_peek(&buttonedges, &edge))
+	{
+		uint32_t idx = edge.button;
+		if((idx > kBoardButtonNone) && (idx < kBoardNumButtons))
+		{
+			if(buttonstreamlen[idx] + kCleanPatternBits <= kStreamBits)
+			{
+				uint32_t pattern = edge.level ? cleanpatterna : (cleanpatternb & 0xFFF);
+				buttoninputbits[idx] |= (pattern << buttonstreamlen[idx]);
+				buttonstreamlen[idx] += kCleanPatternBits;
+			}
+			if(edge.level)	{ BTNMAP_SET(buttonstatus, idx); }
+			else			{ BTNMAP_CLR(buttonstatus, idx); }
+			BTNMAP_SET(buttonstreams, idx);
+			BTNMAP_SET(buttonactivity, idx);
+#if (BOARD_BUTTON_EDGE_TIMES)
+			BTNMAP_SET(buttonedgemask, idx);
+			buttonedgetime[idx] = edge.tm;
+#endif
+		}
+		di_edge_pop(&buttonedges);
+	}
+}
+
 // ============================================================================
 // ----	Public Functions ------------------------------------------------------
 // ============================================================================
 
-bool
-di_read_next_button_input_bit(uint32_t idx)
+void
+di_read_button_inputs(tBoardButtonMap *pinputs)
 {
-	bool retval = ((buttoninputbits[idx] & 1) != 0);
-	buttoninputbits[idx] /= 2;
-	if((!retval) && (!buttoninputbits[idx]))	// if this bit is clear, it could be because the input stream is depleted; if the input stream is also depleted...
-	{	// ... then check whether the "button pressed" flag is true
-		retval = BIT_TEST(buttonstatus, idx);
+	uint32_t idx;
+
+	if(!pinputs)	{ return; }
+	di_drain_button_edges();
+
+	// idle inputs simply read their current level
+	for(idx = 0; idx < kBoardNumButtonWords; ++idx)	{ pinputs[idx] = buttonstatus[idx]; }
+
+	// the simulated inputs are per-button bit streams; advance only those w/ bits left in them.
+	for(idx = 0; idx < kBoardNumButtons; ++idx)
+	{
+		if(!buttonstreams[idx / BOARD_BUTTON_MAP_WORD_BITS])
+		{
+			idx |= BOARD_BUTTON_MAP_WORD_BITS - 1;		// nothing queued in this word; skip to the next
+			continue;
+		}
+		if(!BTNMAP_TEST(buttonstreams, idx))		{ continue; }
+
+		if(di_read_next_button_input_bit(idx))		{ BTNMAP_SET(pinputs, idx); }
+		else										{ BTNMAP_CLR(pinputs, idx); }
+		if(!buttonstreamlen[idx])					{ BTNMAP_CLR(buttonstreams, idx); }
 	}
-	return retval;
 }
 
+void
+di_read_button_activity(tBoardButtonMap *pactivity)
+{
+	uint32_t idx;
+
+	if(!pactivity)	{ return; }
+	di_drain_button_edges();
+	for(idx = 0; idx < kBoardNumButtonWords; ++idx)
+	{
+		pactivity[idx] = buttonactivity[idx];
+		buttonactivity[idx] = 0;
+	}
+}
+
+#if (BOARD_BUTTON_EDGE_TIMES)
+void
+di_read_button_edge_times(tBoardButtonMap *pedges, tCwswClockTics *ptimes)
+{
+	uint32_t idx;
+
+	if(!pedges || !ptimes)	{ return; }
+	di_drain_button_edges();
+	for(idx = 0; idx < kBoardNumButtonWords; ++idx)
+	{
+		pedges[idx] = buttonedgemask[idx];
+		buttonedgemask[idx] = 0;
+	}
+	for(idx = 0; idx < kBoardNumButtons; ++idx)
+	{
+		if(BTNMAP_TEST(pedges, idx))	{ ptimes[idx] = buttonedgetime[idx]; }
+	}
+}
+#endif
+
+/** Scheduler side: bring an idle button scan back to its fast rate if the UI has queued edges.
+ *	Called from the heartbeat, on the thread that runs the button task, before the ticks that are
+ *	due; the UI callbacks only push edges, and never touch the scan alarm themselves.
+ */
+void
+di_button_wake(void)
+{
+	if(di_edge_pending(&buttonedges))	{ Btn_Wake(); }
+}
+
+/** Shared callback for every button control.
+ *	The board's wiring table installs this on each button it binds, w/ the button ID as the
+ *	control's callback data, so a panel w/ any number of buttons needs no per-button code.
+ */
 int CVICALLBACK
-cbBtn0(int panel, int control, int event, void *callbackData, int eventData1, int eventData2)
+cbUiButton(int panel, int control, int event, void *callbackData, int eventData1, int eventData2)
 {
+	uint16_t idx = (uint16_t)(uintptr_t)callbackData;
+	UNUSED(panel);
+	UNUSED(control);
+	UNUSED(eventData1);
+	UNUSED(eventData2);
+
 	switch (event)
 	{
 	case EVENT_LEFT_CLICK:
-		/* using the pattern established for GTK, if the current bit stream is not empty, add the
-		 * new bit stream to the "far end" of the current bitstream. otherwise, just add the new
-		 * bitstream directly.
+		/* using the pattern established for GTK, hand the edge to the DI reader, which adds its
+		 * bit stream to the "far end" of whatever is still queued for this button.
 		 */
-		buttoninputbits[kBoardButton0] += cleanpatterna * 4096; // clean pattern is 12 bits
-		BIT_SET(buttonstatus, kBoardButton0);
+		(void)di_edge_push(&buttonedges, idx, true);
 		break;
 
 	case EVENT_COMMIT:	// LW/CVI's equivalent to a mouse-up (button release) event
-		buttoninputbits[kBoardButton0] += ((cleanpatternb & 0xFFF) * 4096);
-		BIT_CLR(buttonstatus, kBoardButton0);
+		(void)di_edge_push(&buttonedges, idx, false);
 
 		/* running commentaire, to be moved to more formal documentation.
 		 * - if the DI button SM is in the "released" state, the 1st 1 bit will provoke a transition to
@@ -105,68 +238,41 @@ cbBtn0(int panel, int control, int event, void *callbackData, int eventData1, in
 	return 0;
 }
 
+/** Callbacks the panel's UIR (board.uir) names for its buttons; cwsw_board_ui.h, generated from
+ *	it, declares them, so LoadPanel() needs them to exist. Cwsw_Board__Init() replaces each one w/
+ *	cbUiButton() as it binds the buttons; until then they forward, w/ the button ID the UIR can't
+ *	carry. Setting the UIR's button callbacks to cbUiButton (and regenerating the header) retires
+ *	these.
+ *	@{
+ */
 int CVICALLBACK
-cbBtn1(int panel, int control, int event, void *callbackData, int eventData1, int eventData2)
+cbBtn0(int panel, int control, int event, void *callbackData, int eventData1, int eventData2)
 {
-	switch (event)
-	{
-	case EVENT_LEFT_CLICK:
-		buttoninputbits[kBoardButton1] += cleanpatterna * 4096; // clean pattern is 12 bits
-		BIT_SET(buttonstatus, kBoardButton1);
-		break;
-
-	case EVENT_COMMIT:
-		buttoninputbits[kBoardButton1] += ((cleanpatternb & 0xFFF) * 4096);
-		BIT_CLR(buttonstatus, kBoardButton1);
-		break;
+	UNUSED(callbackData);
+	return cbUiButton(panel, control, event, (void *)(uintptr_t)kBoardButton0, eventData1, eventData2);
+}
 
-	default:
-		break;
-	}
-	return 0;
+int CVICALLBACK
+cbBtn1(int panel, int control, int event, void *callbackData, int eventData1, int eventData2)
+{
+	UNUSED(callbackData);
+	return cbUiButton(panel, control, event, (void *)(uintptr_t)kBoardButton1, eventData1, eventData2);
 }
 
 int CVICALLBACK
 cbBtn2(int panel, int control, int event, void *callbackData, int eventData1, int eventData2)
 {
-	switch (event)
-	{
-	case EVENT_LEFT_CLICK:
-		buttoninputbits[kBoardButton2] += cleanpatterna * 4096; // clean pattern is 12 bits
-		BIT_SET(buttonstatus, kBoardButton2);
-		break;
-
-	case EVENT_COMMIT:
-		buttoninputbits[kBoardButton2] += ((cleanpatternb & 0xFFF) * 4096);
-		BIT_CLR(buttonstatus, kBoardButton2);
-		break;
-
-	default:
-		break;
-	}
-	return 0;
+	UNUSED(callbackData);
+	return cbUiButton(panel, control, event, (void *)(uintptr_t)kBoardButton2, eventData1, eventData2);
 }
 
 int CVICALLBACK
 cbBtn3(int panel, int control, int event, void *callbackData, int eventData1, int eventData2)
 {
-	switch (event)
-	{
-	case EVENT_LEFT_CLICK:
-		buttoninputbits[kBoardButton3] += cleanpatterna * 4096; // clean pattern is 12 bits
-		BIT_SET(buttonstatus, kBoardButton3);
-		break;
-
-	case EVENT_COMMIT:
-		buttoninputbits[kBoardButton3] += ((cleanpatternb & 0xFFF) * 4096);
-		BIT_CLR(buttonstatus, kBoardButton3);
-		break;
-
-	default:
-		break;
-	}
-	return 0;
+	UNUSED(callbackData);
+	return cbUiButton(panel, control, event, (void *)(uintptr_t)kBoardButton3, eventData1, eventData2);
 }
+/** @} */
 
 int CVICALLBACK
 cbPanel(int panel, int event, void *callbackData, int eventData1, int eventData2)
@@ -0,0 +1,109 @@
+/** @file
+ *	@brief	API declarations for the analog-input (rheostat) task common to all boards.
+ *
+ *	Every scan, the board hands over a block of samples per channel; the task decimates each block
+ *	to one value, smooths it w/ a first-order IIR filter, and posts an event when the filtered value
+ *	crosses one of the channel's thresholds. The application reads filtered values, and reacts to
+ *	events; it never sees a raw sample.
+ *
+ *	Copyright (c) 2026 agent. All rights reserved.
+ *
+ *	Created on: Oct 14, 2026
+ *	@author agent
+ */
+
+#ifndef CWSW_BSP_ANALOG_H
+#define CWSW_BSP_ANALOG_H
+
+// ============================================================================
+// ----	Include Files ---------------------------------------------------------
+// ============================================================================
+
+// ----	System Headers --------------------------
+#include <stdint.h>
+
+// ----	Project Headers -------------------------
+#include "cwsw_sme.h"			/* tCwswSwAlarm */
+
+// ----	Module Headers --------------------------
+#include "cwsw_board.h"			/* kBoardNumAnalogs */
+
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+// ============================================================================
+// ----	Constants -------------------------------------------------------------
+// ============================================================================
+
+/*	A board w/ analog inputs sets `BOARD_ANALOG` to 1 (in `projcfg.h` or on the command line), and
+ *	its cwsw_board.h defines `kBoardNumAnalogs`, the number of channels (no more than 32).
+ *
+ *	Threshold crossings are posted as `evAnalog_Above` and `evAnalog_Below`, which the project's
+ *	event list must define (seen here through `cwsw_bsp_analog_cfg.h`); evData is the channel.
+ */
+
+#if !defined(AIN_OVERSAMPLE_LOG2)
+/// Samples per channel per scan, as a power of 2: 4 gives 16 samples, averaged to one value.
+#define AIN_OVERSAMPLE_LOG2		4
+#endif
+
+/// Samples per channel in each block read w/ di_read_analog_block().
+#define kAinOversample			(1u << AIN_OVERSAMPLE_LOG2)
+
+
+// ============================================================================
+// ----	Type Definitions ------------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Public Variables ------------------------------------------------------
+// ============================================================================
+
+extern tCwswSwAlarm	Ain_tmr_Read;		// exposed mostly for OS scheduler
+
+
+// ============================================================================
+// ----	Public API ------------------------------------------------------------
+// ============================================================================
+
+/** Board hook for the analog task; implemented by the board (or arch) layer.
+ *	Fill `psamples` w/ a block of `count` consecutive samples of each channel, channel by channel:
+ *	channel N's samples are `psamples[N * count]` .. `psamples[N * count + count - 1]`. Right-
+ *	justified, #BOARD_ANALOG_BITS wide. On hardware, this is one DMA-driven burst of conversions,
+ *	not one conversion per call.
+ */
+extern void di_read_analog_block(uint16_t *psamples, uint32_t count);
+
+/** Send both the scan alarm's events and the threshold events to one queue.
+ *	Shorthand for Ain_SetAlarmQueue() and Ain_SetEventQueue() w/ the same queue.
+ */
+extern void Ain_SetQueue(tEvQ_EventID const evid, const ptEvQ_QueueCtrlEx pEvqx);
+
+/** Queue, and event ID, for the expirations of Ain_tmr_Read that drive the analog task. */
+extern void Ain_SetAlarmQueue(tEvQ_EventID const evid, const ptEvQ_QueueCtrlEx pEvqx);
+
+/** Queue for threshold events; the boards' Init gives it the button queue. */
+extern void Ain_SetEventQueue(const ptEvQ_QueueCtrlEx pEvqx);
+
+extern void Ain_tsk_Read(tEvQ_Event evid, uint32_t extra);
+
+/** Watch channel `channel` for crossings of `hi` (rising) and `lo` (falling), in ADC counts.
+ *	`evAnalog_Above` is posted when the filtered value rises to `hi` or more, and `evAnalog_Below`
+ *	once it then falls to `lo` or less; the gap between the two is the hysteresis. A channel starts
+ *	out below. `hi` of 0 stops watching the channel.
+ *	@returns #kErr_Bsp_BadParm for a channel the board doesn't have, or `lo` not below `hi`.
+ */
+extern uint16_t Ain_SetThresholds(uint32_t channel, uint16_t lo, uint16_t hi);
+
+/** Filtered value of channel `channel`, in ADC counts; 0 before the first scan. */
+extern uint16_t Ain_GetValue(uint32_t channel);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif /* CWSW_BSP_ANALOG_H */
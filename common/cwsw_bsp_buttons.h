@@ -15,9 +15,12 @@
 // ============================================================================
 
 // ----	System Headers --------------------------
+#include <stddef.h>
+#include <stdint.h>
 
 // ----	Project Headers -------------------------
 #include "cwsw_sme.h"
+#include "cwsw_board.h"			/* kBoardNumButtons, tBoardButtonMap */
 
 // ----	Module Headers --------------------------
 
@@ -31,10 +34,86 @@ extern "C" {
 // ----	Constants -------------------------------------------------------------
 // ============================================================================
 
+/** Debounce engines available to the button task.
+ *	Select one by defining #BTN_DEBOUNCE_ENGINE in `projcfg.h` or `cwsw_bsp_buttons_cfg.h`.
+ *	-	#BTN_ENGINE_SME: (default) one SME instance per button; each state function shifts its own
+ *		input bits.
+ *	-	#BTN_ENGINE_VERTICAL: all buttons debounced in one pass, using a 3-bit vertical counter
+ *		across the whole input word.
+ *	-	#BTN_ENGINE_TIMESTAMP: all buttons debounced in one pass, from the time of each button's last
+ *		edge; an input is accepted once it has been quiet for `BTN_QUIET_TIME`.
+ *	@{
+ */
+#define BTN_ENGINE_SME			0
+#define BTN_ENGINE_VERTICAL		1
+#define BTN_ENGINE_TIMESTAMP	2
+/** @} */
+
+#if !defined(BTN_STAT_LATENCY_BINS)
+/** Bins in the press-latency histogram of #tBtnStats. Bin 0 counts latencies of 0 or 1 tick; bin
+ *	N counts [2^N, 2^(N+1)) ticks; the last bin also takes everything longer.
+ */
+#define BTN_STAT_LATENCY_BINS		12
+#endif
+
+#if !defined(BTN_STAT_MAX_TRANSITIONS)
+/// Room in #tBtnStats for one counter per row of the button SM's transition table.
+#define BTN_STAT_MAX_TRANSITIONS	16
+#endif
+
+/** States tracked by the button statistics.
+ *	The whole-word engines have no separate debounce states; their debounce time is counted in the
+ *	state the button is leaving.
+ */
+enum eBtnStatStates {
+	kBtnStatReleased,
+	kBtnStatDebouncePress,
+	kBtnStatPressed,
+	kBtnStatDebounceRelease,
+	kBtnStatStuck,
+	kBtnStatNumStates
+};
+
+/** What a `BTN_TRACE` record holds; byte 7 of each record of the replay format.
+ *	The "none" board replays input records and steps over the rest.
+ */
+enum eBtnTraceKind {
+	kBtnTraceInput,			//!< raw input edge: button ID, and its new level
+	kBtnTraceEvent,			//!< posted button event: evData, and the event ID (low 8 bits)
+	kBtnTraceState,			//!< button SM state change (SME only): button ID, and its new state
+	kBtnTraceNumKinds
+};
+
 // ============================================================================
 // ----	Type Definitions ------------------------------------------------------
 // ============================================================================
 
+/** One tick's worth of debounced press / release changes, when `BTN_BATCH_EVENTS` is enabled.
+ *	Bit N of each mask corresponds to button ID N.
+ */
+typedef struct sBtnBatch {
+	uint32_t		seq;								//!< batch sequence number; matches the event's evData
+	tBoardButtonMap	changed[kBoardNumButtonWords];		//!< buttons whose debounced state changed this tick
+	tBoardButtonMap	state[kBoardNumButtonWords];		//!< debounced state of all buttons; 1 == pressed
+} tBtnBatch;
+
+/** One instance of the button task: its SMs (or debounce words), scan alarm, queues and
+ *	statistics. Opaque; see Btn_NewInstance().
+ */
+typedef struct sBtnInstance tBtnInstance;
+
+/** Button statistics, when `BTN_INSTRUMENTATION` is enabled.
+ *	Counters are updated only when a button changes state, so an idle button costs nothing.
+ *	Times are in clock ticks; a stay in a state is counted when the button leaves it.
+ */
+typedef struct sBtnStats {
+	tCwswClockTics	residency[kBoardNumButtons][kBtnStatNumStates];	//!< time each button has spent in each state
+	uint32_t		latency[BTN_STAT_LATENCY_BINS];		//!< histogram of first-twitch-to-evBntPressed latency
+	uint32_t		transitions[BTN_STAT_MAX_TRANSITIONS];	//!< times each transition-table row was taken (SME only)
+	uint32_t		debouncetimeouts;	//!< debounce windows that ran out w/out a decision (SME only)
+	uint32_t		stuck;				//!< stuck-button events
+} tBtnStats;
+
 // ============================================================================
 // ----	Public Variables ------------------------------------------------------
 // ============================================================================
@@ -46,9 +125,92 @@ extern tCwswSwAlarm	Btn_tmr_ButtonRead;	// exposed mostly for OS scheduler
 // ----	Public API ------------------------------------------------------------
 // ============================================================================
 
+/** Send both the scan alarm's events and the button notifications to one queue.
+ *	Shorthand for Btn_SetAlarmQueue() and Btn_SetEventQueue() w/ the same queue.
+ */
 extern void Btn_SetQueue(tEvQ_EventID const evid, const ptEvQ_QueueCtrlEx pEvqx);
+
+/** Queue, and event ID, for the expirations of Btn_tmr_ButtonRead that drive the button task. */
+extern void Btn_SetAlarmQueue(tEvQ_EventID const evid, const ptEvQ_QueueCtrlEx pEvqx);
+
+/** Queue for button notifications (press, release, stuck, et al.).
+ *	Every notification's evData is the button ID, whichever #BTN_DEBOUNCE_ENGINE is built.
+ */
+extern void Btn_SetEventQueue(const ptEvQ_QueueCtrlEx pEvqx);
+
+/** Optional priority lane: the events picked out by `BTN_PRIORITY_EVENT` (by default
+ *	evBntPressed and evButton_BtnStuck) are posted here instead, so a dispatcher that drains this
+ *	queue first sees them ahead of routine traffic. NULL (the default) turns the lane off.
+ */
+extern void Btn_SetPriorityQueue(const ptEvQ_QueueCtrlEx pEvqx);
 extern void Btn_tsk_ButtonRead(tEvQ_Event evid, uint32_t extra);
 
+/** Claim another instance of the button task, for one more board in the same process.
+ *	Instances come from a pool of `BTN_MAX_INSTANCES` (default 1: just the default instance); call
+ *	this before starting any thread that runs button tasks. The new instance has its own scan alarm
+ *	(see `Get(Cwsw_Board, BtnAlarm)`) and no queues; select it, then set them up as usual.
+ *	@returns the instance, or NULL if the pool is used up.
+ */
+extern tBtnInstance *Btn_NewInstance(void);
+
+/** Select the instance that the rest of this API (including Btn_tsk_ButtonRead()) works on, for
+ *	the calling thread. NULL selects the default instance.
+ *	Boards that host several instances pair this w/ selecting their own input state; see
+ *	Cwsw_Board__SelectInstance() where the board provides one.
+ *	@returns the instance selected until now, to be restored by the caller.
+ */
+extern tBtnInstance *Btn_SelectInstance(tBtnInstance *pinst);
+
+/** Fetch the batch announced by an `evButton_Batch` event.
+ *	Only the last `BTN_BATCH_DEPTH` batches are retained.
+ *	@param[in]	seq	Sequence number, from the event's evData.
+ *	@returns the batch, or NULL if it has already been overwritten.
+ */
+extern tBtnBatch const *Btn_GetBatch(uint32_t seq);
+
+/** Target for `Get(Cwsw_Board, BtnStats)`, when `BTN_INSTRUMENTATION` is enabled.
+ *	@returns the live statistics; they keep counting while the caller reads them.
+ */
+extern tBtnStats const *Cwsw_Board__Get_BtnStats(void);
+
+/** Clear the button statistics; residency restarts from now. */
+extern void Btn_ResetStats(void);
+
+/** Bytes Btn_TraceFlush() needs to write out the trace as it stands, when `BTN_TRACE` is enabled. */
+extern size_t Btn_TraceSize(void);
+
+/** Write out the trace, and start a new one, when `BTN_TRACE` is enabled.
+ *	The output is a replay file for the "none" board: a `CWBR` header, a record for each button
+ *	already pressed when the window opens, then every recorded input edge, state change and event,
+ *	oldest first, w/ the times as deltas. Replaying it reproduces the recorded input stream.
+ *	@returns the bytes written, or 0 (and the trace is kept) if `size` is short of Btn_TraceSize().
+ */
+extern size_t Btn_TraceFlush(void *pbuf, size_t size);
+
+/** Bring the button scan back to its fast rate, e.g. after it slowed down (or parked) while idle.
+ *	Boards call this on every input edge they see, so the first press after a quiet spell isn't
+ *	left waiting out the idle scan period. It writes the selected instance's scan alarm, so it must
+ *	be called on the thread that runs the button task; a board whose edges arrive on a UI thread
+ *	calls it from its heartbeat once it sees them (see di_edge_pending()).
+ */
+extern void Btn_Wake(void);
+
+/** Target for `Get(Cwsw_Board, BtnScanPeriod)`: current period of Btn_tmr_ButtonRead, in ticks.
+ *	0 means the scan is parked until the next Btn_Wake().
+ */
+extern tCwswClockTics Cwsw_Board__Get_BtnScanPeriod(void);
+
+/** Target for `Get(Cwsw_Board, BtnAlarm)`: scan alarm of the selected instance; Btn_tmr_ButtonRead
+ *	for the default instance.
+ */
+extern tCwswSwAlarm *Cwsw_Board__Get_BtnAlarm(void);
+
+/** Target for `Get(Cwsw_Board, BtnEventsPosted)`: button events accepted by the event queue. */
+extern uint32_t Cwsw_Board__Get_BtnEventsPosted(void);
+
+/** Target for `Get(Cwsw_Board, BtnEventsDropped)`: button events the event queue refused. */
+extern uint32_t Cwsw_Board__Get_BtnEventsDropped(void);
+
 
 
 #ifdef	__cplusplus
@@ -0,0 +1,91 @@
+/** @file
+ *	@brief	Back buffer, w/ dirty-span tracking, for a board's text display.
+ *
+ *	The application writes into the back buffer, which costs a compare per character and nothing
+ *	more; each line remembers the one span of columns that changed since the last flush. Once per
+ *	frame (the GTK board: its idle pass), the board flushes, and only those spans are pushed to the
+ *	widget or controller, so a status line rewritten every tick w/ mostly the same text costs one
+ *	small update, not a fresh layout of the whole display.
+ *
+ *	Copyright (c) 2026 agent. All rights reserved.
+ *
+ *	Created on: Oct 14, 2026
+ *	@author agent
+ */
+
+#ifndef CWSW_BSP_DISPLAY_H
+#define CWSW_BSP_DISPLAY_H
+
+// ============================================================================
+// ----	Include Files ---------------------------------------------------------
+// ============================================================================
+
+// ----	System Headers --------------------------
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// ----	Project Headers -------------------------
+
+// ----	Module Headers --------------------------
+#include "../cwsw_board_common.h"	/* BOARD_DISPLAY_ROWS, BOARD_DISPLAY_COLS */
+
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+// ============================================================================
+// ----	Constants -------------------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Type Definitions ------------------------------------------------------
+// ============================================================================
+
+/** A display's text, and what of it the screen has yet to see.
+ *	Lines are not NUL-terminated; every cell holds a printable ASCII character.
+ */
+typedef struct sBoardDisplay {
+	char		text[BOARD_DISPLAY_ROWS][BOARD_DISPLAY_COLS];
+	uint8_t		dirtylo[BOARD_DISPLAY_ROWS];	//!< first changed column of each dirty line
+	uint8_t		dirtyhi[BOARD_DISPLAY_ROWS];	//!< last changed column of each dirty line
+	uint32_t	dirtyrows;						//!< lines w/ a span still to be pushed
+} tBoardDisplay;
+
+/** Board hook for di_display_flush(): show `len` characters at line `row`, column `col`. */
+typedef void (*pfBoardDisplaySpan)(uint32_t row, uint32_t col, const char *text, uint32_t len);
+
+
+// ============================================================================
+// ----	Public Variables ------------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Public API ------------------------------------------------------------
+// ============================================================================
+
+/** Blank the display, and mark every line dirty, so the 1st flush paints the whole screen. */
+extern void di_display_init(tBoardDisplay *pdisp);
+
+/** Write up to `len` characters of `text` at line `row`, column `col`, clipped at the end of the
+ *	line; see Cwsw_Board__DisplayWrite().
+ *	@returns true if any cell changed, i.e. there is something to flush.
+ */
+extern bool di_display_write(tBoardDisplay *pdisp, uint32_t row, uint32_t col, const char *text, size_t len);
+
+/** Blank every line; only cells that weren't blank become dirty.
+ *	@returns true if any cell changed.
+ */
+extern bool di_display_clear(tBoardDisplay *pdisp);
+
+/** Hand each line's dirty span to `pfshow`, top to bottom, and mark the display clean. */
+extern void di_display_flush(tBoardDisplay *pdisp, pfBoardDisplaySpan pfshow);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif /* CWSW_BSP_DISPLAY_H */
@@ -0,0 +1,118 @@
+/** @file
+ *	@brief	Single-producer / single-consumer ring of timestamped button edges.
+ *
+ *	The UI callbacks (producer) push one record per press or release; the DI layer (consumer)
+ *	drains them from the button task. Neither side writes anything the other side writes, so the
+ *	GUI and the scheduler may run on separate threads without a lock.
+ *
+ *	An edge still in the ring is also the UI's request to wake an idle button scan: the producer
+ *	only pushes, and the scheduler side checks di_edge_pending() and calls Btn_Wake() itself, so
+ *	the scan alarm is never written from the GUI thread.
+ *
+ *	Copyright (c) 2026 agent. All rights reserved.
+ *
+ *	Created on: Oct 14, 2026
+ *	@author agent
+ */
+
+#ifndef CWSW_BSP_EDGERING_H
+#define CWSW_BSP_EDGERING_H
+
+// ============================================================================
+// ----	Include Files ---------------------------------------------------------
+// ============================================================================
+
+// ----	System Headers --------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#endif
+
+// ----	Project Headers -------------------------
+#include "cwsw_lib.h"			/* tCwswClockTics */
+
+// ----	Module Headers --------------------------
+
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+// ============================================================================
+// ----	Constants -------------------------------------------------------------
+// ============================================================================
+
+#if !defined(BOARD_EDGE_RING_DEPTH)
+/** Number of edges the ring holds; must be a power of 2.
+ *	An edge sits in the ring for no more than one button-task tick: the consumer drains every edge
+ *	each tick. If that button's simulated input stream is still full, the edge's bounce pattern is
+ *	dropped, but its level is still latched.
+ */
+#define BOARD_EDGE_RING_DEPTH	32
+#endif
+
+
+// ============================================================================
+// ----	Type Definitions ------------------------------------------------------
+// ============================================================================
+
+/** Index type for the ring's head and tail.
+ *	C11 atomics where the compiler has them; otherwise a volatile word, fenced in the .c file.
+ */
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+typedef atomic_uint_least32_t	tBoardEdgeIndex;
+#else
+typedef volatile uint32_t		tBoardEdgeIndex;
+#endif
+
+/// One button edge, as seen by the UI.
+typedef struct sBoardEdge {
+	tCwswClockTics	tm;			//!< time the UI saw the edge
+	uint16_t		button;		//!< button ID
+	uint8_t			level;		//!< 1 for press, 0 for release
+} tBoardEdge;
+
+/** Ring control block.
+ *	`head` is written only by the producer, `tail` only by the consumer. Both are free-running
+ *	counters; the slot is the counter modulo #BOARD_EDGE_RING_DEPTH.
+ */
+typedef struct sBoardEdgeRing {
+	tBoardEdgeIndex	head;		//!< next slot the producer fills
+	tBoardEdgeIndex	tail;		//!< next slot the consumer reads
+	uint32_t		overruns;	//!< edges the producer dropped because the ring was full; producer-owned
+	tBoardEdge		edges[BOARD_EDGE_RING_DEPTH];
+} tBoardEdgeRing;
+
+
+// ============================================================================
+// ----	Public Variables ------------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Public API ------------------------------------------------------------
+// ============================================================================
+
+/** Producer side: record an edge, stamped with the current time.
+ *	@returns false if the ring was full (the edge is dropped, and counted in `overruns`).
+ */
+extern bool di_edge_push(tBoardEdgeRing *pring, uint16_t button, bool level);
+
+/** Consumer side: copy the oldest edge without removing it.
+ *	@returns false if the ring is empty.
+ */
+extern bool di_edge_peek(tBoardEdgeRing *pring, tBoardEdge *pedge);
+
+/** Consumer side: discard the oldest edge, once di_edge_peek() has returned it. */
+extern void di_edge_pop(tBoardEdgeRing *pring);
+
+/** Consumer side: true if any edge is waiting to be drained. */
+extern bool di_edge_pending(tBoardEdgeRing *pring);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif /* CWSW_BSP_EDGERING_H */
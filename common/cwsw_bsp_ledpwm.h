@@ -0,0 +1,82 @@
+/** @file
+ *	@brief	Software PWM (dimming) for a board's bitmapped LEDs.
+ *
+ *	Each dimmed LED is lit on `duty` of every #BOARD_LED_PWM_STEPS ticks, w/ the lit ticks spread
+ *	as evenly as they go (a first-order delta-sigma pattern, not one burst per period), so the
+ *	flicker sits at the highest frequency the tick rate allows. The pattern is a function of the
+ *	CWSW clock alone: the board's heartbeat asks for this tick's output image, and only LEDs whose
+ *	output bit changed are written to the port or widget.
+ *
+ *	Copyright (c) 2026 agent. All rights reserved.
+ *
+ *	Created on: Oct 14, 2026
+ *	@author agent
+ */
+
+#ifndef CWSW_BSP_LEDPWM_H
+#define CWSW_BSP_LEDPWM_H
+
+// ============================================================================
+// ----	Include Files ---------------------------------------------------------
+// ============================================================================
+
+// ----	System Headers --------------------------
+#include <stdint.h>
+
+// ----	Project Headers -------------------------
+#include "cwsw_lib.h"			/* tCwswClockTics */
+
+// ----	Module Headers --------------------------
+#include "../cwsw_board_common.h"	/* BOARD_LED_PWM_STEPS */
+
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+// ============================================================================
+// ----	Constants -------------------------------------------------------------
+// ============================================================================
+
+/// Most LEDs a bitmapped LED image (uint32_t) can hold.
+#define kBoardLedPwmMaxLeds		32
+
+
+// ============================================================================
+// ----	Type Definitions ------------------------------------------------------
+// ============================================================================
+
+/** Dimming state of one board's LEDs.
+ *	A zeroed record dims nothing: every LED shows its image bit as is.
+ */
+typedef struct sBoardLedPwm {
+	uint32_t	dimmed;							//!< LEDs driven at less than full duty
+	uint8_t		duty[kBoardLedPwmMaxLeds];		//!< lit ticks per #BOARD_LED_PWM_STEPS, of each dimmed LED
+} tBoardLedPwm;
+
+
+// ============================================================================
+// ----	Public Variables ------------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Public API ------------------------------------------------------------
+// ============================================================================
+
+/** Set one LED's duty, in ticks lit per #BOARD_LED_PWM_STEPS.
+ *	#BOARD_LED_PWM_STEPS (or more) is full brightness, 0 is dark even when the image says "on".
+ */
+extern void di_led_pwm_set(tBoardLedPwm *ppwm, uint32_t led, uint8_t duty);
+
+/** Output image for tick `now`: `image`, w/ each dimmed LED that is on in it lit only on its share
+ *	of the ticks.
+ */
+extern uint32_t di_led_pwm_apply(tBoardLedPwm const *ppwm, uint32_t image, tCwswClockTics now);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif /* CWSW_BSP_LEDPWM_H */
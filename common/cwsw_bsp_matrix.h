@@ -0,0 +1,81 @@
+/** @file
+ *	@brief	API declarations for the matrix-keypad scan driver common to all boards.
+ *
+ *	Copyright (c) 2026 agent. All rights reserved.
+ *
+ *	Created on: Oct 14, 2026
+ *	@author agent
+ */
+
+#ifndef CWSW_BSP_MATRIX_H
+#define CWSW_BSP_MATRIX_H
+
+// ============================================================================
+// ----	Include Files ---------------------------------------------------------
+// ============================================================================
+
+// ----	System Headers --------------------------
+#include <stdint.h>
+
+// ----	Project Headers -------------------------
+
+// ----	Module Headers --------------------------
+#include "cwsw_board.h"			/* kBoardMatrixRows, kBoardMatrixCols, tBoardButtonMap */
+
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+// ============================================================================
+// ----	Constants -------------------------------------------------------------
+// ============================================================================
+
+/*	A board with a keypad matrix sets `BOARD_BUTTONS_MATRIX` to 1 (in `projcfg.h` or on the command
+ *	line), and its cwsw_board.h defines:
+ *	-	`kBoardMatrixRows`: number of row (strobe) lines.
+ *	-	`kBoardMatrixCols`: number of column (sense) lines; no more than one bitmap word.
+ *	-	`kBoardMatrixFirstButton`: button ID of the key at row 0, column 0.
+ *
+ *	The key at (row, col) is button ID `kBoardMatrixFirstButton + (row * kBoardMatrixCols) + col`.
+ *	With the matrix driver enabled, the board does not implement di_read_button_inputs() or
+ *	di_read_button_activity() itself; the matrix driver provides them on top of the hooks below.
+ */
+
+
+// ============================================================================
+// ----	Type Definitions ------------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Public Variables ------------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Public API ------------------------------------------------------------
+// ============================================================================
+
+/** Board hooks for the matrix scan; implemented by the board (or arch) layer.
+ *	@{
+ */
+/** Drive (strobe) one row line active, and all the others inactive.
+ *	Any settling time the hardware needs before the columns are read belongs in this function.
+ */
+extern void di_matrix_drive_row(uint32_t row);
+
+/** Read all column lines for the currently-driven row.
+ *	@returns bit N set if column N reads "pressed".
+ */
+extern tBoardButtonMap di_matrix_read_columns(void);
+
+/** Return all row lines to their inactive (idle) level after a full scan. */
+extern void di_matrix_release_rows(void);
+/** @} */
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif /* CWSW_BSP_MATRIX_H */
@@ -0,0 +1,224 @@
+/** @file
+ *	@brief	Analog-input (rheostat) task common to all boards.
+ *
+ *	Each scan runs three stages over every channel, each stage one loop over a flat array, so the
+ *	compiler is free to vectorize them:
+ *	-	decimate: the block of #kAinOversample samples is summed, and scaled to 8 fractional bits
+ *		(a box-car average; oversampling by 4^n also buys n bits of resolution).
+ *	-	filter: a first-order IIR (exponential average) w/ a weight of 1 / 2^#AIN_IIR_SHIFT. The
+ *		state is kept scaled up by 2^#AIN_IIR_SHIFT, so the update is all unsigned adds and shifts.
+ *	-	thresholds: only channels being watched, and only when one crosses, cost a branch.
+ *
+ *	\copyright
+ *	Copyright (c) 2026 agent. All rights reserved.
+ *
+ *	Created on: Oct 14, 2026
+ *	@author agent
+ */
+
+// ============================================================================
+// ----	Include Files ---------------------------------------------------------
+// ============================================================================
+
+// ----	System Headers --------------------------
+#include <stdbool.h>
+
+// ----	Project Headers -------------------------
+#include "cwsw_board.h"				// this module builds on top of the BSP
+
+// ----	Module Headers --------------------------
+#include "cwsw_bsp_analog.h"		// public API for this module
+#include "cwsw_bsp_analog_cfg.h"	// project-specific configuration for this module
+
+#if (BOARD_ANALOG)					/* { */
+
+// ============================================================================
+// ----	Constants -------------------------------------------------------------
+// ============================================================================
+
+#if !defined(AIN_IIR_SHIFT)
+/** Weight of each new value in the IIR filter, as 1 / 2^AIN_IIR_SHIFT; 0 turns the filter off.
+ *	At 3, a step settles to within 1% in about 35 scans.
+ */
+#define AIN_IIR_SHIFT			3
+#endif
+
+#if !defined(AIN_SCAN_PERIOD)
+/// Period of Ain_tmr_Read.
+#define AIN_SCAN_PERIOD			tmr10ms
+#endif
+
+/// Fractional bits carried through the filter.
+#define kAinFracBits			8
+
+
+// ============================================================================
+// ----	Type Definitions ------------------------------------------------------
+// ============================================================================
+
+/// compile-time checks: channels fit the bitmaps, the block sum fits its scaling, and the filter state fits 32 bits.
+typedef char tAinChannelsFit[((kBoardNumAnalogs >= 1) && (kBoardNumAnalogs <= 32)) ? 1 : -1];
+typedef char tAinOversampleFits[(AIN_OVERSAMPLE_LOG2 <= kAinFracBits) ? 1 : -1];
+typedef char tAinFilterFits[((BOARD_ANALOG_BITS <= 16) && (BOARD_ANALOG_BITS + kAinFracBits + AIN_IIR_SHIFT <= 32)) ? 1 : -1];
+
+
+// ============================================================================
+// ----	Global Variables ------------------------------------------------------
+// ============================================================================
+
+tCwswSwAlarm	Ain_tmr_Read = {
+	/* .tm			= */AIN_SCAN_PERIOD,
+	/* .reloadtm	= */AIN_SCAN_PERIOD,
+	/* .pEvQX		= */NULL,
+	/* .evid		= */0,
+	/* .tmrstate	= */kTmrState_Enabled
+};
+
+
+// ============================================================================
+// ----	Module-level Variables ------------------------------------------------
+// ============================================================================
+
+static ptEvQ_QueueCtrlEx pAinEvqx = NULL;
+
+/// This scan's samples, channel by channel.
+static uint16_t ainBlock[kBoardNumAnalogs * kAinOversample];
+
+/// Decimated value of each channel this scan, and its filter state; both w/ #kAinFracBits fractional bits.
+static uint32_t ainDecimated[kBoardNumAnalogs];
+static uint32_t ainFilter[kBoardNumAnalogs];		//!< filtered value, times 2^AIN_IIR_SHIFT
+static uint16_t ainValue[kBoardNumAnalogs];			//!< filtered value, rounded to ADC counts
+static bool ainPrimed = false;						//!< the filters have been seeded w/ a first scan
+
+/// Threshold watch: channels watched, and those currently above their upper threshold.
+static uint16_t ainLo[kBoardNumAnalogs];
+static uint16_t ainHi[kBoardNumAnalogs];
+static uint32_t ainWatched = 0;
+static uint32_t ainAbove = 0;
+
+
+// ============================================================================
+// ----	Private Functions -----------------------------------------------------
+// ============================================================================
+
+/// Post one threshold event for channel `channel`.
+static void
+PostAinEvent(tEvQ_EventID evid, uint32_t channel)
+{
+	tEvQ_Event ev;
+
+	ev.evId = evid;
+	ev.evData = channel;
+	(void)Cwsw_EvQX__PostEvent(pAinEvqx, ev);
+}
+
+/// Post the crossings of the watched channels.
+static void
+CheckThresholds(void)
+{
+	uint32_t ch, bits;
+
+	for(ch = 0, bits = ainWatched; bits; ++ch, bits >>= 1)
+	{
+		if(!(bits & 1))	{ continue; }
+		if(!BIT_TEST(ainAbove, ch))
+		{
+			if(ainValue[ch] >= ainHi[ch])
+			{
+				BIT_SET(ainAbove, ch);
+				PostAinEvent(evAnalog_Above, ch);
+			}
+		}
+		else if(ainValue[ch] <= ainLo[ch])
+		{
+			BIT_CLR(ainAbove, ch);
+			PostAinEvent(evAnalog_Below, ch);
+		}
+	}
+}
+
+
+// ============================================================================
+// ----	Public Functions ------------------------------------------------------
+// ============================================================================
+
+void
+Ain_tsk_Read(tEvQ_Event ev, uint32_t extra)
+{
+	const uint16_t *psample;
+	uint32_t ch, idx, sum;
+
+	UNUSED(ev);
+	UNUSED(extra);
+
+	di_read_analog_block(ainBlock, kAinOversample);
+
+	// decimate
+	for(ch = 0; ch < kBoardNumAnalogs; ++ch)
+	{
+		psample = &ainBlock[ch * kAinOversample];
+		for(sum = 0, idx = 0; idx < kAinOversample; ++idx)	{ sum += psample[idx]; }
+		ainDecimated[ch] = sum << (kAinFracBits - AIN_OVERSAMPLE_LOG2);
+	}
+
+	// filter; the 1st scan seeds it, so it doesn't ramp up from 0
+	if(!ainPrimed)
+	{
+		for(ch = 0; ch < kBoardNumAnalogs; ++ch)	{ ainFilter[ch] = ainDecimated[ch] << AIN_IIR_SHIFT; }
+		ainPrimed = true;
+	}
+	for(ch = 0; ch < kBoardNumAnalogs; ++ch)
+	{
+		ainFilter[ch] = ainFilter[ch] - (ainFilter[ch] >> AIN_IIR_SHIFT) + ainDecimated[ch];
+		ainValue[ch] = (uint16_t)(((ainFilter[ch] >> AIN_IIR_SHIFT) + (1u << (kAinFracBits - 1))) >> kAinFracBits);
+	}
+
+	if(ainWatched)	{ CheckThresholds(); }
+}
+
+void
+Ain_SetQueue(tEvQ_EventID const evId, const ptEvQ_QueueCtrlEx pEvqx)
+{
+	Ain_SetEventQueue(pEvqx);
+	Ain_SetAlarmQueue(evId, pEvqx);
+}
+
+void
+Ain_SetAlarmQueue(tEvQ_EventID const evId, const ptEvQ_QueueCtrlEx pEvqx)
+{
+	Ain_tmr_Read.pEvQX = pEvqx;
+	Ain_tmr_Read.evid = evId;
+}
+
+void
+Ain_SetEventQueue(const ptEvQ_QueueCtrlEx pEvqx)
+{
+	pAinEvqx = pEvqx;
+}
+
+uint16_t
+Ain_SetThresholds(uint32_t channel, uint16_t lo, uint16_t hi)
+{
+	if(channel >= kBoardNumAnalogs)	{ return kErr_Bsp_BadParm; }
+	if(!hi)
+	{
+		BIT_CLR(ainWatched, channel);
+		BIT_CLR(ainAbove, channel);
+		return kErr_Bsp_NoError;
+	}
+	if(lo >= hi)	{ return kErr_Bsp_BadParm; }
+
+	ainLo[channel] = lo;
+	ainHi[channel] = hi;
+	BIT_CLR(ainAbove, channel);
+	BIT_SET(ainWatched, channel);
+	return kErr_Bsp_NoError;
+}
+
+uint16_t
+Ain_GetValue(uint32_t channel)
+{
+	return (channel < kBoardNumAnalogs) ? ainValue[channel] : 0;
+}
+
+#endif											/* } */
@@ -27,10 +27,161 @@
 // ----	Constants -------------------------------------------------------------
 // ============================================================================
 
+#if !defined(BTN_DEBOUNCE_ENGINE)
+/// Debounce engine used by the button task. Default is the per-button SME.
+#define BTN_DEBOUNCE_ENGINE		BTN_ENGINE_SME
+#endif
+
+#if !defined(BTN_QUIET_TIME)
+/** #BTN_ENGINE_TIMESTAMP: time an input must go w/out an edge before its level is accepted.
+ *	Press-to-event latency is this, plus up to one scan period; it does not depend on a sample count.
+ */
+#define BTN_QUIET_TIME			(tmr10ms * 2)
+#endif
+
+#if !defined(BTN_BATCH_EVENTS)
+/** Coalesce each tick's press and release notifications into one #evButton_Batch event.
+ *	When enabled, the project's event list (`cwsw_bsp_buttons_cfg.h`) must define `evButton_Batch`.
+ */
+#define BTN_BATCH_EVENTS		(0)
+#endif
+
+#if !defined(BTN_BATCH_DEPTH)
+/// Number of batch records retained for the application to fetch w/ Btn_GetBatch().
+#define BTN_BATCH_DEPTH			(4)
+#endif
+
+#if !defined(BTN_EARLY_PRESS)
+/** Post a tentative press on a button's first "1" sample, ahead of the debounce; then a confirm
+ *	when the press is debounced, or a cancel if the debounce gives up or settles back to released.
+ *	evBntPressed is still posted as usual. When enabled, the project's event list must define
+ *	`evButton_EarlyPress`, `evButton_PressConfirmed` and `evButton_PressCancelled`.
+ *
+ *	To limit it to some buttons, define `BTN_EARLY_PRESS_BUTTONS` in `cwsw_bsp_buttons_cfg.h` as a
+ *	list of `BTN_EARLY(button)` entries; otherwise every button takes part.
+ */
+#define BTN_EARLY_PRESS			(0)
+#endif
+
+#if !defined(BTN_GESTURES)
+/** Detect long presses, auto-repeat, and double / triple clicks, and post an event for each:
+ *	`evButton_LongPress`, `evButton_Repeat`, `evButton_DoubleClick` and `evButton_TripleClick`,
+ *	which the project's event list must then define. evData is the button ID.
+ *	The hold time comes from the button's stuck timer, so a held button needs no timer of its own.
+ */
+#define BTN_GESTURES			(0)
+#endif
+
+#if !defined(BTN_LONGPRESS_TIME)
+/// #BTN_GESTURES: hold time that makes a long press; must be shorter than the stuck time.
+#define BTN_LONGPRESS_TIME		tmr1000ms
+#endif
+
+#if !defined(BTN_REPEAT_PERIOD)
+/// #BTN_GESTURES: period of the repeat events that follow a long press; 0 for no repeat.
+#define BTN_REPEAT_PERIOD		tmr100ms
+#endif
+
+#if !defined(BTN_MULTICLICK_TIME)
+/// #BTN_GESTURES: longest gap between a release and the next press for them to count as one gesture.
+#define BTN_MULTICLICK_TIME		(tmr100ms * 3)
+#endif
+
+#if !defined(BTN_PRIORITY_EVENT)
+/** Button events posted to the priority queue, when one is set w/ Btn_SetPriorityQueue().
+ *	Everything else goes to the event queue.
+ */
+#define BTN_PRIORITY_EVENT(evid)	(((evid) == evBntPressed) || ((evid) == evButton_BtnStuck))
+#endif
+
+#if !defined(BTN_INSTRUMENTATION)
+/** Keep the statistics read w/ Get(Cwsw_Board, BtnStats): state residency, press latency, and
+ *	transition, debounce-timeout and stuck counts. They cost a few increments per state change.
+ */
+#define BTN_INSTRUMENTATION		(0)
+#endif
+
+#if !defined(BTN_TRACE)
+/** Keep a trace of the last #BTN_TRACE_DEPTH input edges, SM state changes and posted events,
+ *	read out w/ Btn_TraceFlush() in the format the "none" board replays. Steady inputs cost one
+ *	compare per input word each tick; only changes are recorded.
+ */
+#define BTN_TRACE				(0)
+#endif
+
+#if !defined(BTN_TRACE_DEPTH)
+/// #BTN_TRACE: entries kept in each instance's trace ring, 8 bytes each; a power of 2.
+#define BTN_TRACE_DEPTH			256
+#endif
+
+#if !defined(BTN_TRACE_LEAD_IN)
+/** #BTN_TRACE: quiet time written ahead of the oldest entry by Btn_TraceFlush(), so that a replay
+ *	settles the buttons held at the start of the window before the first recorded edge.
+ */
+#define BTN_TRACE_LEAD_IN		tmr100ms
+#endif
+
+#if !defined(BTN_TRACE_FAULT_EVENT)
+/// #BTN_TRACE: posted events that call `cbBTN_TRACE_FAULT()`, e.g. to flush the trace to storage.
+#define BTN_TRACE_FAULT_EVENT(evid)	((evid) == evButton_BtnStuck)
+#endif
+
+#if !defined(cbBTN_TRACE_FAULT)
+/** #BTN_TRACE: the project's fault action, run in the button task right after a fault event is
+ *	posted; the project defines this in projcfg.h, typically as a call to Btn_TraceFlush().
+ */
+#define cbBTN_TRACE_FAULT()
+#endif
+
+#if !defined(BTN_MAX_INSTANCES)
+/** Button instances available in this build, including the default instance used by the plain
+ *	API. More are claimed w/ Btn_NewInstance(), e.g. to host several simulated boards in one process.
+ */
+#define BTN_MAX_INSTANCES		1
+#endif
+
+#if !defined(BTN_SCAN_PERIOD)
+/// Scan period while any button is active: debouncing, pressed, or stuck.
+#define BTN_SCAN_PERIOD			tmr10ms
+#endif
+
+#if !defined(BTN_SCAN_IDLE_PERIOD)
+/** Scan period while every button rests in the Released state; by default the same as
+ *	#BTN_SCAN_PERIOD, i.e. a fixed rate. A longer period (e.g. tmr100ms) slows the idle scan down,
+ *	and 0 parks the scan alarm altogether; either way, the board must then see to it that
+ *	Btn_Wake() is called on every input edge, or the first press waits out the idle period.
+ */
+#define BTN_SCAN_IDLE_PERIOD	BTN_SCAN_PERIOD
+#endif
+
+/// Target for TM(tmrBtnDeadline): local copy of the deadline of the button being serviced.
+#define GET_tmrBtnDeadline()	Cwsw_GetTimeLeft(tmrBtnDeadline)
+
 /// "Reason3" reasons for exiting a state.
-enum { kReasonNone, kReasonTwitchNoted, kReasonDebounced, kReasonTimeout, kReasonButtonUnstuck };
+enum { kReasonNone, kReasonTwitchNoted, kReasonDebounced, kReasonTimeout, kReasonButtonUnstuck, kNumReasons };
+
+/// State IDs for the button SM; index into the state-handler table.
+enum eBtnStates {
+	kBtnStateNone,				//!< not running; the next step restarts the SM
+	kBtnStateStart,
+	kBtnStateReleased,
+	kBtnStateDebouncePress,
+	kBtnStatePressed,
+	kBtnStateDebounceRelease,
+	kBtnStateStuck,
+	kBtnNumStates
+};
 
-/// @todo Move this to a board-specific calibration.
+/// Reason1 (event ID) slots in the transition index.
+enum eBtnReason1Slots {
+	kBtnReason1Task,
+	kBtnReason1Pressed,
+	kBtnReason1Released,
+	kBtnReason1Other,
+	kBtnNumReason1Slots
+};
+
+/// Default calibration; see #BTN_CALIBRATION_TABLE to override it per button.
 enum eButtonCalibrationValues {
 	/// Stuck button timeout value.
 	kButtonStuckTimeoutValue = tmr1000ms * 30,
@@ -50,18 +201,213 @@ enum eButtonCalibrationValues {
 	kTmButtonDebounceTime = tmr500ms + tmr100ms
 };
 
+#if !defined(BTN_CAL_SAMPLES)
+/** Consecutive equal samples that debounce a press or release (1 .. 8).
+ *	Counts the sample that started the debounce, so the SME needs this many minus one more reads.
+ */
+#define BTN_CAL_SAMPLES			8
+#endif
+
+#if !defined(BTN_CAL_DEBOUNCE_TIME)
+/// Longest a debounce may take before the SME gives up on it (#BTN_ENGINE_SME only).
+#define BTN_CAL_DEBOUNCE_TIME	kTmButtonDebounceTime
+#endif
+
+#if !defined(BTN_CAL_STUCK_TIME)
+/// Time a button may be held before it is reported stuck.
+#define BTN_CAL_STUCK_TIME		kButtonStuckTimeoutValue
+#endif
+
+/*	Per-button calibration.
+ *	A project that wants some buttons to differ from the defaults above defines, in
+ *	`cwsw_bsp_buttons_cfg.h`, a list of `BTN_CAL(button, samples, debounce time, stuck time)` rows:
+ *
+ *		#define BTN_CALIBRATION_TABLE \
+ *			BTN_CAL(kBoardButton1, 3, tmr100ms, tmr1000ms * 30)	\
+ *			BTN_CAL(kBoardButton2, 8, 0, 0)
+ *
+ *	A 0 (samples or time) takes the default; buttons not listed take the defaults for everything.
+ *	The values are read when a button enters the state that uses them, never in the per-tick
+ *	comparison, and w/out a table they are plain constants.
+ *
+ *	#BTN_ENGINE_TIMESTAMP uses only the stuck time; its debounce is #BTN_QUIET_TIME for every button.
+ */
+#if defined(BTN_CALIBRATION_TABLE)
+#define BtnCalSamples(idx)		(tblBtnCal[idx].samples ? tblBtnCal[idx].samples : BTN_CAL_SAMPLES)
+#define BtnCalDebounceTime(idx)	(tblBtnCal[idx].debounce ? tblBtnCal[idx].debounce : BTN_CAL_DEBOUNCE_TIME)
+#define BtnCalStuckTime(idx)	(tblBtnCal[idx].stuck ? tblBtnCal[idx].stuck : BTN_CAL_STUCK_TIME)
+#else
+#define BtnCalSamples(idx)		BTN_CAL_SAMPLES
+#define BtnCalDebounceTime(idx)	BTN_CAL_DEBOUNCE_TIME
+#define BtnCalStuckTime(idx)	BTN_CAL_STUCK_TIME
+#endif
+
+/// mask of the debounce shift-register bits that must all agree
+#define BtnCalStableMask(idx)	((uint8_t)((1u << BtnCalSamples(idx)) - 1u))
+
 
 // ============================================================================
 // ----	Type Definitions ------------------------------------------------------
 // ============================================================================
 
+/// Transition function, called when the row's transition is taken.
+typedef void (*pfBtnTransition)(tEvQ_Event ev, uint32_t extra);
+
+/** One row of the button SM's transition table.
+ *	Same columns as the CWSW SME's table, but states are identified by ID so that the table can be
+ *	indexed directly.
+ */
+typedef struct sBtnTransition {
+	uint8_t			CurrentState;	//!< state ID this row applies to
+	tEvQ_EventID	Reason1;		//!< exit reason 1: event that provoked the exit
+	uint32_t		Reason2;		//!< exit reason 2: button ID, or 0xFF for any button
+	uint32_t		Reason3;		//!< exit reason 3: one of the kReasonXxx codes
+	uint8_t			NextState;		//!< state ID to enter
+	pfBtnTransition	Transition;		//!< transition action; may be NULL
+} tBtnTransition;
+
+/// One button's calibration, when #BTN_CALIBRATION_TABLE is used; a 0 field takes the default.
+typedef struct sBtnCalibration {
+	uint8_t			samples;		//!< consecutive equal samples that debounce the input
+	tCwswClockTics	debounce;		//!< longest a debounce may take
+	tCwswClockTics	stuck;			//!< hold time before the button is reported stuck
+} tBtnCalibration;
+
+/// Per-button gesture state, for #BTN_GESTURES.
+typedef struct sBtnGesture {
+	tCwswClockTics	released;		//!< time of the last debounced release
+	uint16_t		repeats;		//!< repeat events posted during this press
+	uint8_t			clicks;			//!< presses so far in the current multi-click
+	uint8_t			longpress;		//!< nonzero once this press has been reported as a long press
+} tBtnGesture;
+
+/** One entry of the #BTN_TRACE ring.
+ *	Kept as absolute time, so that overwriting the oldest entry leaves the others intact; the
+ *	flush turns the times into deltas.
+ */
+typedef struct sBtnTraceEntry {
+	tCwswClockTics	tm;				//!< time of the scan that saw the change
+	uint16_t		id;				//!< button ID; evData for an event
+	uint8_t			kind;			//!< eBtnTraceKind
+	uint8_t			level;			//!< input level, new SM state, or event ID
+} tBtnTraceEntry;
+
+/** Per-button SM context.
+ *	Everything one button's SM needs is kept together: the state functions share one record,
+ *	rather than each holding its own arrays; only one state is active at a time, so one deadline
+ *	serves both the debounce window and the stuck-button timeout.
+ */
+typedef struct sBtnContext {
+	tCwswClockTics	deadline;		//!< timer for the current state (debounce window, stuck timeout)
+	tEvQ_EventID	evId;			//!< exit reason 1
+	uint8_t			state;			//!< current state ID (eBtnStates)
+	uint8_t			phase;			//!< phase within the current state (tStateReturnCodes)
+	uint8_t			readbits;		//!< debounce shift register
+	uint8_t			stablemask;		//!< bits of `readbits` that must agree; from this button's calibration
+	uint8_t			reason3;		//!< exit reason 3
+} tBtnContext;
+
+/** Everything one instance of the button task keeps from one tick to the next.
+ *	The plain API works on the instance selected for the calling thread w/ Btn_SelectInstance();
+ *	unless another is selected, that is the default instance, whose scan alarm is
+ *	Btn_tmr_ButtonRead.
+ */
+struct sBtnInstance {
+	tCwswSwAlarm		*ptmr;			//!< scan alarm: Btn_tmr_ButtonRead for the default instance, else `tmr`
+	tCwswSwAlarm		tmr;
+
+	/// Queues for button notifications: the routine lane, and the optional priority lane.
+	ptEvQ_QueueCtrlEx	pBtnEvqx;
+	ptEvQ_QueueCtrlEx	pBtnPriorityEvqx;
+
+	/// Posting statistics; read w/ Get(Cwsw_Board, BtnEventsPosted) and Get(Cwsw_Board, BtnEventsDropped).
+	uint32_t			btnEventsPosted;
+	uint32_t			btnEventsDropped;
+
+	/// Current period of the scan alarm; 0 while the alarm is parked. Read w/ Get(Cwsw_Board, BtnScanPeriod).
+	tCwswClockTics		btnScanPeriod;
+
+#if (BTN_BATCH_EVENTS)
+	/// Changes accumulated during the current tick, and the most recent published batches.
+	tBtnBatch			btnPendingBatch;
+	tBtnBatch			btnBatches[BTN_BATCH_DEPTH];
+	uint32_t			btnBatchSeq;
+#endif
+
+#if (BTN_INSTRUMENTATION)
+	/// Statistics, and the bookkeeping behind them: each button's current stat state and when it was
+	///	entered, and the time of the first twitch of a press still being debounced.
+	tBtnStats			btnStats;
+	uint8_t				btnStatState[kBoardNumButtons];
+	tCwswClockTics		btnStatEntered[kBoardNumButtons];
+	tBoardButtonMap		btnTwitchArmed[kBoardNumButtonWords];
+	tCwswClockTics		btnTwitchTime[kBoardNumButtons];
+#endif
+
+#if (BTN_TRACE)
+	/// Trace ring, and the input levels around it: as of the newest entry, and just before the oldest.
+	tBtnTraceEntry		btnTrace[BTN_TRACE_DEPTH];
+	uint32_t			btnTraceHead;		//!< slot of the next entry
+	uint32_t			btnTraceCount;		//!< entries held, up to #BTN_TRACE_DEPTH
+	tBoardButtonMap		btnTraceLevel[kBoardNumButtonWords];
+	tBoardButtonMap		btnTraceBase[kBoardNumButtonWords];
+#endif
+
+#if (BTN_EARLY_PRESS)
+	/// buttons w/ a tentative press outstanding: posted, and not yet confirmed or cancelled.
+	tBoardButtonMap		btnTentative[kBoardNumButtonWords];
+#endif
+
+#if (BTN_GESTURES)
+	tBtnGesture			btnGestures[kBoardNumButtons];
+#endif
+
+	/// DI snapshot for the current tick, shared by all buttons' SMs.
+	tBoardButtonMap		btnInputs[kBoardNumButtonWords];
+
+#if (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_SME)
+	/// Button SM context for every button; the state functions work on the entry of the button at hand.
+	tBtnContext			btnContext[kBoardNumButtons];
+	tBoardButtonMap		btnParked[kBoardNumButtonWords];		//!< buttons idling in Released or Stuck w/ nothing to do
+	tBoardButtonMap		btnParkedLevel[kBoardNumButtonWords];	//!< input level each parked button waits to see change: 0 in Released, 1 in Stuck
+
+#else
+	/// whole-word engines: debounced state, stuck flags, and stuck timers. bit N of each word belongs to button N.
+	tBoardButtonMap		btnDebounced[kBoardNumButtonWords];
+	tBoardButtonMap		btnStuck[kBoardNumButtonWords];
+	tCwswClockTics		tmrStuck[kBoardNumButtons];
+#endif
+
+#if (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_VERTICAL)
+	/* vertical-counter debounce state.
+	 * vcnt2:vcnt1:vcnt0 form a 3-bit counter per button, counting consecutive samples that disagree
+	 * with the debounced state.
+	 */
+	tBoardButtonMap		vcnt0[kBoardNumButtonWords];
+	tBoardButtonMap		vcnt1[kBoardNumButtonWords];
+	tBoardButtonMap		vcnt2[kBoardNumButtonWords];
+#if (BTN_EARLY_PRESS)
+	/// second vertical counter: consecutive "0" samples of buttons w/ a tentative press outstanding.
+	tBoardButtonMap		vzcnt0[kBoardNumButtonWords];
+	tBoardButtonMap		vzcnt1[kBoardNumButtonWords];
+	tBoardButtonMap		vzcnt2[kBoardNumButtonWords];
+#endif
+
+#elif (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_TIMESTAMP)
+	/// edge-timestamp debounce state: previous sample, buttons waiting out their quiet time, and when each last moved.
+	tBoardButtonMap		btnLastSample[kBoardNumButtonWords];
+	tBoardButtonMap		btnPending[kBoardNumButtonWords];
+	tCwswClockTics		btnEdgeTime[kBoardNumButtons];
+#endif
+};
+
 // ============================================================================
 // ----	Global Variables ------------------------------------------------------
 // ============================================================================
 
 tCwswSwAlarm	Btn_tmr_ButtonRead = {
-	/* .tm			= */tmr10ms,
-	/* .reloadtm	= */tmr10ms,
+	/* .tm			= */BTN_SCAN_PERIOD,
+	/* .reloadtm	= */BTN_SCAN_PERIOD,
 	/* .pEvQX		= */NULL,
 	/* .evid		= */0,
 	/* .tmrstate	= */kTmrState_Enabled
@@ -72,15 +418,86 @@ tCwswSwAlarm	Btn_tmr_ButtonRead = {
 // ----	Module-level Variables ------------------------------------------------
 // ============================================================================
 
-static ptEvQ_QueueCtrlEx pBtnEvqx = NULL;
+/* instance 0 is the default instance; the rest are handed out by Btn_NewInstance(). the current
+ * instance is kept per thread, so threads running different instances don't see each other's.
+ */
+static tBtnInstance btnInstances[BTN_MAX_INSTANCES] = {
+	{ .ptmr = &Btn_tmr_ButtonRead, .btnScanPeriod = BTN_SCAN_PERIOD }
+};
+static uint32_t btnInstancesUsed = 1;
+static BOARD_THREAD_LOCAL tBtnInstance *pBtn = &btnInstances[0];
+
+#if defined(BTN_CALIBRATION_TABLE)
+/// compile-time check of every row's sample count (0 for the default): the SME's shift register is 8 bits wide.
+#define BTN_CAL(btn, n, db, st)	typedef char tBtnCalSamplesFit_##btn[((n) <= 8) ? 1 : -1];
+BTN_CALIBRATION_TABLE
+#undef BTN_CAL
+
+#define BTN_CAL(btn, n, db, st)	[btn] = { (n), (db), (st) },
+static const tBtnCalibration tblBtnCal[kBoardNumButtons] = {
+	BTN_CALIBRATION_TABLE
+};
+#undef BTN_CAL
+#endif
+
+/// compile-time check of the default sample count.
+typedef char tBtnCalSamplesFit[((BTN_CAL_SAMPLES >= 1) && (BTN_CAL_SAMPLES <= 8)) ? 1 : -1];
+
+#if (BTN_TRACE)
+/// compile-time check: the trace ring wraps w/ a mask.
+typedef char tBtnTraceDepthIsPow2[(BTN_TRACE_DEPTH && !(BTN_TRACE_DEPTH & (BTN_TRACE_DEPTH - 1))) ? 1 : -1];
+#endif
+
+#if (BTN_GESTURES)
+/// compile-time check: a long press must be recognizable before the default stuck time.
+typedef char tBtnLongPressBeforeStuck[((tCwswClockTics)BTN_LONGPRESS_TIME < (tCwswClockTics)BTN_CAL_STUCK_TIME) ? 1 : -1];
+#endif
+
+#if (BTN_EARLY_PRESS)
+#if defined(BTN_EARLY_PRESS_BUTTONS)
+#define BTN_EARLY(btn)			[btn] = true,
+static const bool tblBtnEarly[kBoardNumButtons] = {
+	BTN_EARLY_PRESS_BUTTONS
+};
+#undef BTN_EARLY
+#define BtnEarlyPress(idx)		(tblBtnEarly[idx])
+#else
+#define BtnEarlyPress(idx)		(true)
+#endif
+#endif
+
+#if (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_VERTICAL)
+/* count, modulo 8, at which each button's input is accepted: bit planes of its calibrated sample
+ * count, laid out like the counter. w/out a calibration table, every button has the same count,
+ * and each plane is a constant. the calibration is the same for every instance, so they share one
+ * set of planes.
+ */
+#if defined(BTN_CALIBRATION_TABLE)
+static tBoardButtonMap vcthr0[kBoardNumButtonWords] = {0};
+static tBoardButtonMap vcthr1[kBoardNumButtonWords] = {0};
+static tBoardButtonMap vcthr2[kBoardNumButtonWords] = {0};
+static bool vcthrready = false;
+#define VcThreshold(plane, idxword)	(vcthr##plane[idxword])
+#else
+#define VcThreshold(plane, idxword)	((BTN_CAL_SAMPLES & (1u << (plane))) ? ~(tBoardButtonMap)0 : 0)
+#endif
+#endif
+
+
+#if (BTN_GESTURES)
+// ============================================================================
+// ----	Private Prototypes ----------------------------------------------------
+// ============================================================================
+
+static void GestureHeld(uint32_t idxbutton, tCwswClockTics timeleft);
+#endif
 
 
 // ============================================================================
 // ----	State Functions -------------------------------------------------------
 // ============================================================================
 
-/** @todo Move this prototype to a legitimate header - probably board level */
-extern bool di_read_next_button_input_bit(uint32_t idx);
+#if (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_SME)		/* { */
 
 /** Button-debounce state.
  *	This routine is common for states when you're detecting a button push, and a release.
@@ -88,24 +505,22 @@ extern bool di_read_next_button_input_bit(uint32_t idx);
 static tStateReturnCodes
 stDebounceButton(ptEvQ_Event pev, uint32_t *pextra)
 {
-	static tStateReturnCodes statephase[kBoardNumButtons] = {kStateUninit};
-	static tCwswClockTics tmrMyStateTimer[kBoardNumButtons] = {0}, tmrdebounce;
-	static tEvQ_EventID evId[kBoardNumButtons] = {0};
-	static uint32_t reason3[kBoardNumButtons] = {kReasonNone};
-	static uint8_t read_bits[kBoardNumButtons] = {0};
+	tCwswClockTics tmrBtnDeadline;
+	tBtnContext *pctx;
 	uint32_t thisbutton;
 
 	if(!pev)	{return 0;}
 	if(!pextra)	{return 0;}
 
 	thisbutton = pev->evData;
-	switch(statephase[thisbutton]++)
+	pctx = &pBtn->btnContext[thisbutton];
+	switch(pctx->phase++)
 	{
 	case kStateUninit:	/* on 1ste entry, execute on-entry action */
 	case kStateFinished:	/* upon return to this state after previous normal exit, execute on-entry action */
 	default:			/* for any unexpected value, restart this state. */
-		evId[thisbutton] = pev->evId;				// save exit Reason1
-		statephase[thisbutton] = kStateOperational;	// reinitialize state's phase marker unilaterally
+		pctx->evId = pev->evId;				// save exit Reason1
+		pctx->phase = kStateOperational;	// reinitialize state's phase marker unilaterally
 
 		/* for this task, we assume the transition was provoked by a non-zero bit on the most recent
 		 * DI bit read. seed our debounce var with that 1st bit.
@@ -114,73 +529,74 @@ stDebounceButton(ptEvQ_Event pev, uint32_t *pextra)
 		 * recognize a switch release (the 1st 0 read is thrown away, then it needs another one to
 		 * "clear" this seeding of the initial 1).
 		 */
-		read_bits[thisbutton] = 1;
+		pctx->readbits = 1;
+		pctx->stablemask = BtnCalStableMask(thisbutton);
 
 		// start my state timer. remember, our call rate is 10 ms. 100ms == 10 bit readings, 640ms is 64 bit reads
-		Set(Cwsw_Clock, tmrMyStateTimer[thisbutton], kTmButtonDebounceTime);
+		Set(Cwsw_Clock, pctx->deadline, BtnCalDebounceTime(thisbutton));
 		break;
 
 	case kStateOperational:
-		// TM() API doesn't work w/ array syntax; copy to local scalar timer
-		tmrdebounce = tmrMyStateTimer[thisbutton];
+		// TM() API doesn't work w/ structure syntax; copy to local scalar timer
+		tmrBtnDeadline = pctx->deadline;
 		// read next bit
-		read_bits[thisbutton] <<= 1;				// shift current bits left one position
-		read_bits[thisbutton] = (uint8_t)(read_bits[thisbutton] | di_read_next_button_input_bit(thisbutton));
-		if(read_bits[thisbutton] == 0)
+		pctx->readbits <<= 1;				// shift current bits left one position
+		pctx->readbits = (uint8_t)(pctx->readbits | BTNMAP_TEST(pBtn->btnInputs, thisbutton));
+		if((pctx->readbits & pctx->stablemask) == 0)
 		{
 			// debounce done, recognized as an open (released) button
-			evId[thisbutton] = evBtnReleased;
-			reason3[thisbutton] = kReasonDebounced;
+			pctx->evId = evBtnReleased;
+			pctx->reason3 = kReasonDebounced;
 		}
-		else if(read_bits[thisbutton] == 0xFF)
+		else if((pctx->readbits & pctx->stablemask) == pctx->stablemask)
 		{
 			// debounce done, recognized as button press, advance to next state
-			evId[thisbutton] = evBntPressed;
-			reason3[thisbutton] = kReasonDebounced;
+			pctx->evId = evBntPressed;
+			pctx->reason3 = kReasonDebounced;
 		}
-		else if(TM(tmrdebounce))
+		else if(TM(tmrBtnDeadline))
 		{
-			reason3[thisbutton] = kReasonTimeout;
+			pctx->reason3 = kReasonTimeout;
 		}
 		else
 		{
-			--statephase[thisbutton];		// nothing of note happened, stay in this state
+			--pctx->phase;		// nothing of note happened, stay in this state
 		}
 		break;
 
 	case kStateExit:
 		// for this edition of this state, no state-specific exit action is required.
 		//	let the caller (normally the SME) know what event and what guard provoked the change.
-		pev->evId = evId[thisbutton];	// save exit reason 1 (event that provoked the exit)
-		pev->evData = thisbutton;		// save exit reason 2 (button recognized)
-		*pextra = reason3[thisbutton];	// save exit reason 3 (reason for exit (no button, button, timeout)
+		pev->evId = pctx->evId;		// save exit reason 1 (event that provoked the exit)
+		pev->evData = thisbutton;	// save exit reason 2 (button recognized)
+		*pextra = pctx->reason3;	// save exit reason 3 (reason for exit (no button, button, timeout)
 		break;
 	}
 
 	// the next line is part of the template and should not be touched.
-	return statephase[thisbutton];
+	return pctx->phase;
 }
 
 
 static tStateReturnCodes
 stStart(ptEvQ_Event pev, uint32_t *pextra)
 {
-	static tStateReturnCodes statephase[kBoardNumButtons] = {kStateUninit};
-	static tEvQ_EventID evId[kBoardNumButtons];
+	tBtnContext *pctx;
 	uint32_t thisbutton;
 
 	if(!pev)	{ return 0; }
 	if(!pextra)	{ return 0; }
 
 	thisbutton = pev->evData;
-	switch(statephase[thisbutton]++)
+	pctx = &pBtn->btnContext[thisbutton];
+	switch(pctx->phase++)
 	{
 	case kStateUninit:	/* on 1st entry, execute on-entry action */
 	case kStateFinished:	/* upon return to this state after previous normal exit, execute on-entry action */
 	default:			/* for any unexpected value, restart this state. */
 		// generic state management, common to all states
-		statephase[thisbutton]	= kStateOperational;
-		evId[thisbutton]		= pev->evId;			// save default exit reason 1.
+		pctx->phase	= kStateOperational;
+		pctx->evId	= pev->evId;			// save default exit reason 1.
 
 		// ---- state-specific behavior ---------
 		// no state-specific behavior for this state
@@ -193,9 +609,9 @@ stStart(ptEvQ_Event pev, uint32_t *pextra)
 
 	case kStateExit:
 		// manage the state machine: set exit reasons
-		pev->evId = evId[thisbutton];	// exit reason 1: event that provoked the exit.
-		pev->evData = thisbutton;		// exit reason 2
-		*pextra = kReasonNone;			// exit reason 3 (for debugging use in transition)
+		pev->evId = pctx->evId;		// exit reason 1: event that provoked the exit.
+		pev->evData = thisbutton;	// exit reason 2
+		*pextra = kReasonNone;		// exit reason 3 (for debugging use in transition)
 
 		// state-specific behavior
 		/* (no state-specific exit actions here) */
@@ -204,7 +620,7 @@ stStart(ptEvQ_Event pev, uint32_t *pextra)
 	}
 
 	// the next line is part of the template and should not be touched.
-	return statephase[thisbutton];
+	return pctx->phase;
 }
 
 /**	Implement the Button Released state of the SM.
@@ -219,20 +635,21 @@ stStart(ptEvQ_Event pev, uint32_t *pextra)
 static tStateReturnCodes
 stButtonReleased(ptEvQ_Event pev, uint32_t *pextra)
 {
-	static tStateReturnCodes statephase[kBoardNumButtons] = {kStateUninit};
+	tBtnContext *pctx;
 	uint32_t thisbutton;
 
 	if(!pev)	{return 0;}
 	if(!pextra)	{return 0;}
 
 	thisbutton = pev->evData;
-	switch(statephase[thisbutton]++)
+	pctx = &pBtn->btnContext[thisbutton];
+	switch(pctx->phase++)
 	{
 	case kStateUninit:		/* on 1st entry, execute on-entry action */
 	case kStateFinished:	/* upon return to this state after previous normal exit, execute on-entry action */
 	default:				/* for any unexpected value, restart this state. */
 		// generic state management, common to all states
-		statephase[thisbutton] = kStateOperational;	// reinitialize state's phase marker unilaterally
+		pctx->phase = kStateOperational;	// reinitialize state's phase marker unilaterally
 
 		// ---- state-specific behavior ---------
 		// no state-specific behavior for this state
@@ -242,12 +659,12 @@ stButtonReleased(ptEvQ_Event pev, uint32_t *pextra)
 	case kStateOperational:
 		do {
 			// use local var so i can override it during debugging.
-			bool thisbit = di_read_next_button_input_bit(thisbutton);	// issue #3: pass the current button
+			bool thisbit = BTNMAP_TEST(pBtn->btnInputs, thisbutton);	// issue #3: pass the current button
 			if(!thisbit)
 			{
 				// stay in this state until we see a twitch on one of the button inputs.
 				//	note: in this iteration of this implementation, we're only reading "button" 0
-				--statephase[thisbutton];
+				--pctx->phase;
 			}
 		} while(0);
 		break;
@@ -265,7 +682,7 @@ stButtonReleased(ptEvQ_Event pev, uint32_t *pextra)
 	}
 
 	// the next line is part of the template and should not be touched.
-	return statephase[thisbutton];
+	return pctx->phase;
 }
 /** @} */
 
@@ -278,54 +695,53 @@ stDebouncePress(ptEvQ_Event pev, uint32_t *pextra)
 static tStateReturnCodes
 stButtonPressed(ptEvQ_Event pev, uint32_t *pextra)
 {
-	static tStateReturnCodes statephase[kBoardNumButtons] = {kStateUninit};
-	static tCwswClockTics tmrPressedStateTimer[kBoardNumButtons] = {0}, tmrPressed;
-	static tEvQ_EventID evId[kBoardNumButtons] = {0};
-	static uint32_t reason2[kBoardNumButtons] = {0};
-	static uint32_t reason3[kBoardNumButtons] = {kReasonNone};
+	tCwswClockTics tmrBtnDeadline;
+	tBtnContext *pctx;
 	uint32_t thisbutton;
 
 	if(!pev)	{return 0;}
 	if(!pextra)	{return 0;}
 
 	thisbutton = pev->evData;
-	switch(statephase[thisbutton]++)
+	pctx = &pBtn->btnContext[thisbutton];
+	switch(pctx->phase++)
 	{
 	case kStateUninit:
 	case kStateFinished:
 	default:
-		evId[thisbutton] = pev->evId;				// save exit Reason1
-		reason3[thisbutton] = kReasonNone;			// save default exit Reason3
-		statephase[thisbutton] = kStateOperational;	// reinitialize state's phase marker unilaterally
+		pctx->evId = pev->evId;				// save exit Reason1
+		pctx->reason3 = kReasonNone;		// save default exit Reason3
+		pctx->phase = kStateOperational;	// reinitialize state's phase marker unilaterally
 
 		/* for this task, we stay here as long as the button remains pressed, or until the timeout
 		 * period expires. a "release" is seen as a zero bit on the bit input stream.
 		 */
-		Set(Cwsw_Clock, tmrPressedStateTimer[thisbutton], kButtonStuckTimeoutValue);
+		Set(Cwsw_Clock, pctx->deadline, BtnCalStuckTime(thisbutton));
 //		printf("Entering %s\n", __FUNCTION__);
 		break;
 
 	case kStateOperational:
 		do {
 			bool thisbit;
-			tmrPressed = tmrPressedStateTimer[thisbutton];
+			tmrBtnDeadline = pctx->deadline;
 			// use local var so i can override it during debugging.
-			thisbit = di_read_next_button_input_bit(thisbutton);
+			thisbit = BTNMAP_TEST(pBtn->btnInputs, thisbutton);
 			if(!thisbit)
 			{
 				// button might have been released, go to debounce-release state to confirm
-				reason2[thisbutton] = thisbutton;
-				reason3[thisbutton] = kReasonTwitchNoted;
+				pctx->reason3 = kReasonTwitchNoted;
 			}
-			else if(TM(tmrPressed))
+			else if(TM(tmrBtnDeadline))
 			{
 				// we've been too long in the pressed-button state, there might be a stuck button
-				reason2[thisbutton] = 0;
-				reason3[thisbutton] = kReasonTimeout;
+				pctx->reason3 = kReasonTimeout;
 			}
 			else
 			{
-				--statephase[thisbutton];	// nothing of note happened, stay in this state
+#if (BTN_GESTURES)
+				GestureHeld(thisbutton, Cwsw_GetTimeLeft(tmrBtnDeadline));
+#endif
+				--pctx->phase;	// nothing of note happened, stay in this state
 			}
 		} while(0);
 		break;
@@ -333,15 +749,16 @@ stButtonPressed(ptEvQ_Event pev, uint32_t *pextra)
 	case kStateExit:
 		// for this edition of this state, no state-specific exit action is required.
 		//	let the caller (normally the SME) know what event and what guard provoked the change.
-		pev->evId = evId[thisbutton];		// save exit reason 1 (event that provoked the exit)
-		pev->evData = reason2[thisbutton];	// save exit reason 2 (button recognized)
-		*pextra = reason3[thisbutton];		// save exit reason 3 (reason for exit (no button, button, timeout)
+		pev->evId = pctx->evId;		// save exit reason 1 (event that provoked the exit)
+		// save exit reason 2 (the button; on a timeout too, so evButton_BtnStuck names it on every engine)
+		pev->evData = thisbutton;
+		*pextra = pctx->reason3;	// save exit reason 3 (reason for exit (no button, button, timeout)
 //		printf("Leaving %s\n", __FUNCTION__);
 		break;
 	}
 
 	// the next line is part of the template and should not be touched.
-	return statephase[thisbutton];
+	return pctx->phase;
 }
 
 static tStateReturnCodes
@@ -353,30 +770,31 @@ stDebounceRelease(ptEvQ_Event pev, uint32_t *pextra)
 static tStateReturnCodes
 stButtonStuck(ptEvQ_Event pev, uint32_t *pextra)
 {
-	static tStateReturnCodes statephase[kBoardNumButtons] = {kStateUninit};
-	static tEvQ_EventID evId[kBoardNumButtons] = {0};
+	tBtnContext *pctx;
 	uint32_t thisbutton;
 
 	if(!pev)	{return 0;}
 	if(!pextra)	{return 0;}
 
 	thisbutton = pev->evData;
-	switch(statephase[thisbutton]++)
+	pctx = &pBtn->btnContext[thisbutton];
+	switch(pctx->phase++)
 	{
 	case kStateUninit:	/* on 1st entry, execute on-entry action */
 	case kStateFinished:	/* upon return to this state after previous normal exit, execute on-entry action */
 	default:			/* for any unexpected value, restart this state. */
-		evId[thisbutton] = pev->evId;	// save exit Reason1
+		pctx->evId = pev->evId;				// save exit Reason1
+		pctx->phase = kStateOperational;	// reinitialize state's phase marker unilaterally
 //		printf("Entering %s\n", __FUNCTION__);
 		break;
 
 	case kStateOperational:
 		do {
-			bool thisbit = di_read_next_button_input_bit(0);
+			bool thisbit = BTNMAP_TEST(pBtn->btnInputs, thisbutton);
 			if(thisbit)
 			{
 				// stay in this state as long as we read a "1" bit
-				--statephase[thisbutton];
+				--pctx->phase;
 			}
 		} while(0);
 		break;
@@ -384,7 +802,7 @@ stButtonStuck(ptEvQ_Event pev, uint32_t *pextra)
 	case kStateExit:
 		// for this edition of this state, no state-specific exit action is required.
 		//	let the caller (normally the SME) know what event and what guard provoked the change.
-		pev->evId = evId[thisbutton];	// save exit reason 1 (event that provoked the exit)
+		pev->evId = pctx->evId;	// save exit reason 1 (event that provoked the exit)
 
 		// there's one and only one reason we leave this state, no reason for supplying reasons.
 		//	However, to allow the transition action to make an informed decision, indicate a unique
@@ -396,14 +814,286 @@ stButtonStuck(ptEvQ_Event pev, uint32_t *pextra)
 	}
 
 	// the next line is part of the template and should not be touched.
-	return statephase[thisbutton];
+	return pctx->phase;
+}
+
+#endif											/* } */
+
+
+// ============================================================================
+// ----	Private Functions -----------------------------------------------------
+// ============================================================================
+
+#if (BTN_TRACE)
+/** Add one entry to the trace ring, overwriting the oldest once it is full.
+ *	An input edge that falls out of the ring is folded into the levels the window starts from.
+ */
+static void
+TraceRecord(uint8_t kind, uint32_t id, uint8_t level)
+{
+	tBtnTraceEntry *pent = &pBtn->btnTrace[pBtn->btnTraceHead];
+
+	if(pBtn->btnTraceCount < BTN_TRACE_DEPTH)	{ ++pBtn->btnTraceCount; }
+	else if(pent->kind == kBtnTraceInput)
+	{
+		if(pent->level)	{ BTNMAP_SET(pBtn->btnTraceBase, pent->id); }
+		else			{ BTNMAP_CLR(pBtn->btnTraceBase, pent->id); }
+	}
+
+	pent->tm	= Get(Cwsw_Clock, Now);
+	pent->id	= (uint16_t)id;
+	pent->kind	= kind;
+	pent->level	= level;
+	pBtn->btnTraceHead = (pBtn->btnTraceHead + 1) & (BTN_TRACE_DEPTH - 1);
+}
+
+/// Record every input that changed since the last recorded sample; a steady word costs one compare.
+static void
+TraceInputs(void)
+{
+	tBoardButtonMap bits;
+	uint32_t idxword, idxbutton;
+
+	for(idxword = 0; idxword < kBoardNumButtonWords; ++idxword)
+	{
+		bits = pBtn->btnInputs[idxword] ^ pBtn->btnTraceLevel[idxword];
+		if(!bits)	{ continue; }
+		pBtn->btnTraceLevel[idxword] = pBtn->btnInputs[idxword];
+
+		idxbutton = idxword * BOARD_BUTTON_MAP_WORD_BITS;
+		for( ; bits && (idxbutton < kBoardNumButtons); bits >>= 1, ++idxbutton)
+		{
+			if(bits & 1)	{ TraceRecord(kBtnTraceInput, idxbutton, BTNMAP_TEST(pBtn->btnInputs, idxbutton) ? 1 : 0); }
+		}
+	}
+}
+
+static void
+WrLe32(uint8_t *p, uint32_t v)
+{
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+}
+
+/// Write one 8-byte record of the replay format.
+static uint8_t *
+WrTraceRecord(uint8_t *p, uint32_t delta, uint16_t id, uint8_t level, uint8_t kind)
+{
+	WrLe32(p, delta);
+	p[4] = (uint8_t)id;
+	p[5] = (uint8_t)(id >> 8);
+	p[6] = level;
+	p[7] = kind;
+	return p + 8;
+}
+#endif
+
+/** Post one button event, and keep count of the ones the queue would not accept.
+ *	Events picked out by #BTN_PRIORITY_EVENT go to the priority queue, if there is one; if it is
+ *	full, they fall back to the event queue rather than being lost.
+ */
+static void
+PostBtnEvent(tEvQ_Event ev)
+{
+	if(pBtn->pBtnPriorityEvqx && BTN_PRIORITY_EVENT(ev.evId) &&
+	   (Cwsw_EvQX__PostEvent(pBtn->pBtnPriorityEvqx, ev) == kErr_Lib_NoError))
+	{
+		++pBtn->btnEventsPosted;
+	}
+	else if(Cwsw_EvQX__PostEvent(pBtn->pBtnEvqx, ev) == kErr_Lib_NoError)
+	{
+		++pBtn->btnEventsPosted;
+	}
+	else
+	{
+		++pBtn->btnEventsDropped;
+	}
+
+#if (BTN_TRACE)
+	TraceRecord(kBtnTraceEvent, ev.evData, (uint8_t)ev.evId);
+	if(BTN_TRACE_FAULT_EVENT(ev.evId))	{ cbBTN_TRACE_FAULT(); }
+#endif
+}
+
+/** Change the scan alarm's period.
+ *	A longer period starts now. A shorter one fires at the earlier of the scan already due and one
+ *	new period from now: a button that wakes up is serviced at the fast rate right away, w/out
+ *	pushing back an idle scan that was due sooner.
+ */
+static void
+SetScanPeriod(tCwswClockTics period)
+{
+	tCwswClockTics tmrnext;
+
+	if(period == pBtn->btnScanPeriod)	{ return; }
+
+	if(!period)
+	{
+		pBtn->ptmr->tmrstate = kTmrState_Disabled;
+	}
+	else
+	{
+		pBtn->ptmr->reloadtm = period;
+		// TM() API doesn't work w/ structure syntax; copy to local scalar timer
+		tmrnext = pBtn->ptmr->tm;
+		if(!pBtn->btnScanPeriod)
+		{
+			Set(Cwsw_Clock, pBtn->ptmr->tm, period);			// parked alarm has no scan due
+			pBtn->ptmr->tmrstate = kTmrState_Enabled;			// un-park
+		}
+		else if((period > pBtn->btnScanPeriod) || (Cwsw_GetTimeLeft(tmrnext) > period))
+		{
+			Set(Cwsw_Clock, pBtn->ptmr->tm, period);
+		}
+	}
+	pBtn->btnScanPeriod = period;
+}
+
+#if (BTN_BATCH_EVENTS)
+/** Publish this tick's accumulated press / release changes, if any, as one batch event.
+ *	The event's evData is the batch sequence number, to be handed to Btn_GetBatch().
+ */
+static void
+PostBtnBatch(void)
+{
+	tBoardButtonMap anychange = 0;
+	tBtnBatch *pbatch;
+	tEvQ_Event ev;
+	uint32_t idx;
+
+	for(idx = 0; idx < kBoardNumButtonWords; ++idx)	{ anychange |= pBtn->btnPendingBatch.changed[idx]; }
+	if(!anychange)	{ return; }
+
+	if(!++pBtn->btnBatchSeq)	{ pBtn->btnBatchSeq = 1; }	// sequence 0 is reserved for "no batch"
+	pbatch = &pBtn->btnBatches[pBtn->btnBatchSeq % BTN_BATCH_DEPTH];
+	*pbatch = pBtn->btnPendingBatch;
+	pbatch->seq = pBtn->btnBatchSeq;
+
+	// the pending state mask carries forward; only the change mask starts over each tick
+	for(idx = 0; idx < kBoardNumButtonWords; ++idx)	{ pBtn->btnPendingBatch.changed[idx] = 0; }
+
+	ev.evId = evButton_Batch;
+	ev.evData = pBtn->btnBatchSeq;
+	PostBtnEvent(ev);
+}
+#endif
+
+
+#if (BTN_INSTRUMENTATION)
+/** Close out a button's stay in its current state, and start timing the next. */
+static void
+StatEnter(uint32_t idxbutton, uint8_t statstate)
+{
+	tCwswClockTics now = Get(Cwsw_Clock, Now);
+	pBtn->btnStats.residency[idxbutton][pBtn->btnStatState[idxbutton]] += now - pBtn->btnStatEntered[idxbutton];
+	pBtn->btnStatEntered[idxbutton] = now;
+	pBtn->btnStatState[idxbutton] = statstate;
+}
+
+/** Note the first twitch of a possible press; later twitches of the same press don't restart it. */
+static void
+StatTwitch(uint32_t idxbutton)
+{
+	if(BTNMAP_TEST(pBtn->btnTwitchArmed, idxbutton))	{ return; }
+	BTNMAP_SET(pBtn->btnTwitchArmed, idxbutton);
+	pBtn->btnTwitchTime[idxbutton] = Get(Cwsw_Clock, Now);
+}
+
+/** A press was accepted: log its latency from the first twitch. */
+static void
+StatPressed(uint32_t idxbutton)
+{
+	tCwswClockTics latency;
+	uint32_t bin = 0;
+
+	if(!BTNMAP_TEST(pBtn->btnTwitchArmed, idxbutton))	{ return; }
+	BTNMAP_CLR(pBtn->btnTwitchArmed, idxbutton);
+
+	latency = Get(Cwsw_Clock, Now) - pBtn->btnTwitchTime[idxbutton];
+	while((latency >>= 1) && (bin < BTN_STAT_LATENCY_BINS - 1))	{ ++bin; }
+	++pBtn->btnStats.latency[bin];
+}
+#endif
+
+
+#if (BTN_GESTURES)
+static void
+PostGesture(tEvQ_EventID evid, uint32_t idxbutton)
+{
+	tEvQ_Event ev;
+	ev.evId = evid;
+	ev.evData = idxbutton;
+	PostBtnEvent(ev);
+}
+
+/** A debounced press: count it toward a multi-click if it follows the last release closely enough. */
+static void
+GesturePressed(uint32_t idxbutton)
+{
+	tBtnGesture *pg = &pBtn->btnGestures[idxbutton];
+
+	pg->longpress = 0;
+	pg->repeats = 0;
+	if(pg->clicks && ((Get(Cwsw_Clock, Now) - pg->released) <= BTN_MULTICLICK_TIME))
+	{
+		++pg->clicks;
+	}
+	else
+	{
+		pg->clicks = 1;
+	}
+
+	if(pg->clicks == 2)			{ PostGesture(evButton_DoubleClick, idxbutton); }
+	else if(pg->clicks == 3)
+	{
+		PostGesture(evButton_TripleClick, idxbutton);
+		pg->clicks = 0;			// a 4th press starts over
+	}
+}
+
+/** A debounced release: start the multi-click window; a long press doesn't count as a click. */
+static void
+GestureReleased(uint32_t idxbutton)
+{
+	tBtnGesture *pg = &pBtn->btnGestures[idxbutton];
+
+	pg->released = Get(Cwsw_Clock, Now);
+	if(pg->longpress)	{ pg->clicks = 0; }
 }
 
+/** A button still held, this tick.
+ *	@param[in]	timeleft	Time left on the button's stuck timer.
+ */
+static void
+GestureHeld(uint32_t idxbutton, tCwswClockTics timeleft)
+{
+	tBtnGesture *pg = &pBtn->btnGestures[idxbutton];
+	tCwswClockTics held = BtnCalStuckTime(idxbutton) - timeleft;
+
+	if(held < BTN_LONGPRESS_TIME)	{ return; }
+	if(!pg->longpress)
+	{
+		pg->longpress = 1;
+		PostGesture(evButton_LongPress, idxbutton);
+	}
+	else if((BTN_REPEAT_PERIOD > 0) &&		// (time constants are enums, so this can't be an #if)
+			(held >= BTN_LONGPRESS_TIME + (tCwswClockTics)(pg->repeats + 1) * BTN_REPEAT_PERIOD))
+	{
+		++pg->repeats;
+		PostGesture(evButton_Repeat, idxbutton);
+	}
+}
+#endif
+
 
 // ============================================================================
 // ----	Transition Functions --------------------------------------------------
 // ============================================================================
 
+#if (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_SME)		/* { */
+
 /** Do-nothing transition function.
  *	This is entirely a debugging aid, it is not required by the transition table.
  */
@@ -414,6 +1104,7 @@ NullTransition(tEvQ_Event ev, uint32_t extra)
 	UNUSED(extra);
 //	printf("Transition: ev: %i, Button: %i, Transition ID: %i\n", ev.evId, ev.evData, extra);
 }
+#endif											/* } */
 
 /** Transition Function.
  * 	This function notifies the world of a state change in our button-reading SM.
@@ -440,6 +1131,17 @@ NotifyBtnStateChg(tEvQ_Event ev, uint32_t extra)
 		{
 		case evBtnReleased:	// button has been released
 		case evBntPressed:	// state change to Pressed state
+#if (BTN_GESTURES)
+			if(ev.evId == evBntPressed)	{ GesturePressed(ev.evData); }
+			else						{ GestureReleased(ev.evData); }
+#endif
+#if (BTN_BATCH_EVENTS)
+			// record it in this tick's batch, instead of posting it by itself
+			BTNMAP_SET(pBtn->btnPendingBatch.changed, ev.evData);
+			if(ev.evId == evBntPressed)	{ BTNMAP_SET(pBtn->btnPendingBatch.state, ev.evData); }
+			else						{ BTNMAP_CLR(pBtn->btnPendingBatch.state, ev.evData); }
+			ev.evId = 0;
+#endif
 			break;
 
 		default:
@@ -450,6 +1152,9 @@ NotifyBtnStateChg(tEvQ_Event ev, uint32_t extra)
 
 	case kReasonTimeout:
 		ev.evId = evButton_BtnStuck;
+#if (BTN_INSTRUMENTATION)
+		++pBtn->btnStats.stuck;
+#endif
 		break;
 
 	case kReasonButtonUnstuck:
@@ -462,11 +1167,72 @@ NotifyBtnStateChg(tEvQ_Event ev, uint32_t extra)
 	}
 	if(ev.evId)
 	{
-		(void)Cwsw_EvQX__PostEvent(pBtnEvqx, ev);
+		PostBtnEvent(ev);
+	}
+}
+
+#if (BTN_EARLY_PRESS)
+/** Post one of the early-press events for a button, and track whether its tentative press is
+ *	outstanding. A confirm or cancel is only posted for a button w/ a tentative press outstanding.
+ */
+static void
+NotifyEarlyPress(tEvQ_EventID evid, uint32_t idxbutton)
+{
+	tEvQ_Event ev;
+
+	if(!BtnEarlyPress(idxbutton))	{ return; }
+	if(evid == evButton_EarlyPress)
+	{
+		if(BTNMAP_TEST(pBtn->btnTentative, idxbutton))	{ return; }
+		BTNMAP_SET(pBtn->btnTentative, idxbutton);
 	}
+	else
+	{
+		if(!BTNMAP_TEST(pBtn->btnTentative, idxbutton))	{ return; }
+		BTNMAP_CLR(pBtn->btnTentative, idxbutton);
+	}
+	ev.evId = evid;
+	ev.evData = idxbutton;
+	PostBtnEvent(ev);
 }
+#endif
 
+#if (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_SME) && (BTN_EARLY_PRESS)	/* { */
+/** Transition out of Released on a twitch: the tentative press. */
+static void
+NotifyTwitch(tEvQ_Event ev, uint32_t extra)
+{
+	UNUSED(extra);
+	NotifyEarlyPress(evButton_EarlyPress, ev.evData);
+}
 
+/** Transition into Pressed: confirm the tentative press, then announce the press as usual. */
+static void
+NotifyPressDebounced(tEvQ_Event ev, uint32_t extra)
+{
+	NotifyEarlyPress(evButton_PressConfirmed, ev.evData);
+	NotifyBtnStateChg(ev, extra);
+}
+
+/** Transition from debounce-press back to Released (bounced back, or timed out): cancel. */
+static void
+NotifyPressAbandoned(tEvQ_Event ev, uint32_t extra)
+{
+	UNUSED(extra);
+	NotifyEarlyPress(evButton_PressCancelled, ev.evData);
+}
+
+#define BtnTrTwitch				NotifyTwitch
+#define BtnTrPressDebounced		NotifyPressDebounced
+#define BtnTrPressAbandoned		NotifyPressAbandoned
+#elif (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_SME)
+#define BtnTrTwitch				NullTransition
+#define BtnTrPressDebounced		NotifyBtnStateChg
+#define BtnTrPressAbandoned		NullTransition
+#endif																/* } */
+
+
+#if (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_SME)		/* { */
 /* the button reads use the following state machine:
  * start -> released -> debounce-press -> pressed -> debounce-release
  * 				^				|			|               |
@@ -475,27 +1241,437 @@ NotifyBtnStateChg(tEvQ_Event ev, uint32_t extra)
  *
  *	~these transitions are in the same order as listed in the design document.~ (not anymore)
  */
-static tTransitionTable tblTransitions[] = {
-	// current				Reason1					Reason2		Reason3					Next State			Transition Func
-	{ stStart,				evButton_Task,	0xFF,	kReasonNone,			stButtonReleased,	NullTransition		},	// normal termination
+static const tBtnTransition tblTransitions[] = {
+	// current					Reason1			Reason2	Reason3					Next State					Transition Func
+	{ kBtnStateStart,			evButton_Task,	0xFF,	kReasonNone,			kBtnStateReleased,			NullTransition		},	// normal termination
 
-	{ stButtonReleased,		evButton_Task,	0xFF,	kReasonTwitchNoted,		stDebouncePress,	NullTransition		},	// normal termination: non-0 bit seen @ button
+	{ kBtnStateReleased,		evButton_Task,	0xFF,	kReasonTwitchNoted,		kBtnStateDebouncePress,		BtnTrTwitch			},	// normal termination: non-0 bit seen @ button
 
-	{ stDebouncePress,		evBntPressed,	0xFF,	kReasonDebounced,		stButtonPressed,	NotifyBtnStateChg	},	// normal termination (debounced input is 0xFF)
-	{ stDebouncePress,		evBtnReleased,	0xFF,	kReasonDebounced,		stButtonReleased,	NullTransition		},	// debounced input is 0. no need to post event, since debounced state hasn't changed.
-	{ stDebouncePress,		evButton_Task,	0xFF,	kReasonTimeout,			stButtonReleased,	NullTransition		},	// debounce timeout
+	{ kBtnStateDebouncePress,	evBntPressed,	0xFF,	kReasonDebounced,		kBtnStatePressed,			BtnTrPressDebounced	},	// normal termination (all of the calibrated samples read "1")
+	{ kBtnStateDebouncePress,	evBtnReleased,	0xFF,	kReasonDebounced,		kBtnStateReleased,			BtnTrPressAbandoned	},	// debounced input is 0. no need to post event, since debounced state hasn't changed.
+	{ kBtnStateDebouncePress,	evButton_Task,	0xFF,	kReasonTimeout,			kBtnStateReleased,			BtnTrPressAbandoned	},	// debounce timeout
 
-	{ stButtonPressed,		evButton_Task,	0xFF,	kReasonTwitchNoted,		stDebounceRelease,	NullTransition		},
-	{ stButtonPressed,		evButton_Task,	0xFF,	kReasonTimeout,			stButtonStuck,		NotifyBtnStateChg	},	// button stuck, go directly back to "stuck" state
+	{ kBtnStatePressed,			evButton_Task,	0xFF,	kReasonTwitchNoted,		kBtnStateDebounceRelease,	NullTransition		},
+	{ kBtnStatePressed,			evButton_Task,	0xFF,	kReasonTimeout,			kBtnStateStuck,				NotifyBtnStateChg	},	// button stuck, go directly back to "stuck" state
 
-	{ stDebounceRelease,	evBtnReleased,	0xFF,	kReasonDebounced,		stButtonReleased,	NotifyBtnStateChg	},
-	{ stDebounceRelease,	evBntPressed,	0xFF,	kReasonDebounced,		stButtonPressed,	NullTransition		},
+	{ kBtnStateDebounceRelease,	evBtnReleased,	0xFF,	kReasonDebounced,		kBtnStateReleased,			NotifyBtnStateChg	},
+	{ kBtnStateDebounceRelease,	evBntPressed,	0xFF,	kReasonDebounced,		kBtnStatePressed,			NullTransition		},
 
 	// in the interests of simplicity (MVP), we'll jump directly back to the Released state.
 	//	we could insert another instance of the debouncer, but except for transition time, the end effect will be the same.
-	{ stButtonStuck,		evButton_Task,	0xFF,	kReasonButtonUnstuck,	stButtonReleased,	NotifyBtnStateChg	},
+	{ kBtnStateStuck,			evButton_Task,	0xFF,	kReasonButtonUnstuck,	kBtnStateReleased,			NotifyBtnStateChg	},
+};
+
+/// State handlers, indexed by state ID.
+static const pfStateHandler tblStates[kBtnNumStates] = {
+	/* kBtnStateNone			*/	NULL,
+	/* kBtnStateStart			*/	stStart,
+	/* kBtnStateReleased		*/	stButtonReleased,
+	/* kBtnStateDebouncePress	*/	stDebouncePress,
+	/* kBtnStatePressed			*/	stButtonPressed,
+	/* kBtnStateDebounceRelease	*/	stDebounceRelease,
+	/* kBtnStateStuck			*/	stButtonStuck
 };
 
+/* transition index, built once from tblTransitions. each cell holds (row + 1) of the first row for
+ * that (current state, Reason1, Reason3) key, or 0 if none; rows sharing a key (i.e., differing
+ * only in Reason2) are chained in table order through tblDispatchChain.
+ */
+static uint8_t tblDispatch[kBtnNumStates][kBtnNumReason1Slots][kNumReasons]	= {{{0}}};
+static uint8_t tblDispatchChain[TABLE_SIZE(tblTransitions)]					= {0};
+static bool dispatchready = false;
+
+/// compile-time check that every row number, plus one, fits in the index cells.
+typedef char tBtnDispatchIsWideEnough[(TABLE_SIZE(tblTransitions) < 0xFF) ? 1 : -1];
+
+#if (BTN_INSTRUMENTATION)
+/// compile-time check that every row has a counter in tBtnStats.
+typedef char tBtnStatsHaveEveryRow[(TABLE_SIZE(tblTransitions) <= BTN_STAT_MAX_TRANSITIONS) ? 1 : -1];
+
+/// Stat state for each SM state; Start is a pass-through on the way to Released.
+static const uint8_t tblStatStates[kBtnNumStates] = {
+	/* kBtnStateNone			*/	kBtnStatReleased,
+	/* kBtnStateStart			*/	kBtnStatReleased,
+	/* kBtnStateReleased		*/	kBtnStatReleased,
+	/* kBtnStateDebouncePress	*/	kBtnStatDebouncePress,
+	/* kBtnStatePressed			*/	kBtnStatPressed,
+	/* kBtnStateDebounceRelease	*/	kBtnStatDebounceRelease,
+	/* kBtnStateStuck			*/	kBtnStatStuck
+};
+
+/** Account for one transition of one button's SM. */
+static void
+StatTransition(uint32_t idxbutton, uint32_t row, uint32_t extra)
+{
+	const tBtnTransition *ptran = &tblTransitions[row];
+
+	++pBtn->btnStats.transitions[row];
+	if((extra == kReasonTimeout) &&
+	   ((ptran->CurrentState == kBtnStateDebouncePress) || (ptran->CurrentState == kBtnStateDebounceRelease)))
+	{
+		++pBtn->btnStats.debouncetimeouts;
+	}
+
+	if(ptran->NextState == kBtnStateDebouncePress)	{ StatTwitch(idxbutton); }
+	else if((ptran->NextState == kBtnStatePressed) && (ptran->CurrentState == kBtnStateDebouncePress))
+	{
+		StatPressed(idxbutton);
+	}
+	else if((ptran->CurrentState == kBtnStateDebouncePress) && (extra == kReasonDebounced))
+	{
+		BTNMAP_CLR(pBtn->btnTwitchArmed, idxbutton);	// settled back to released; that twitch was noise
+	}
+	// a debounce timeout keeps the twitch: the same press is still being worked out
+
+	StatEnter(idxbutton, tblStatStates[ptran->NextState]);
+}
+#endif
+
+
+// ============================================================================
+// ----	Button SME ------------------------------------------------------------
+// ============================================================================
+
+/** Collapse Reason1 onto a small dense range for the dispatch index.
+ *	Events not consumed by the transition table share the last slot; the full Reason1 value is
+ *	still compared before a row is taken, so the shared slot can't produce a false match.
+ */
+static uint32_t
+Reason1Slot(tEvQ_EventID evid)
+{
+	switch(evid)
+	{
+	case evButton_Task:	return kBtnReason1Task;
+	case evBntPressed:	return kBtnReason1Pressed;
+	case evBtnReleased:	return kBtnReason1Released;
+	default:			return kBtnReason1Other;
+	}
+}
+
+/** Build the (state, Reason1, Reason3) index over tblTransitions.
+ *	Rows are linked in reverse so each chain ends up in table order, preserving the "first match
+ *	wins" semantics of a linear search.
+ */
+static void
+BuildDispatchIndex(void)
+{
+	uint32_t row = TABLE_SIZE(tblTransitions);
+	uint8_t *pcell;
+
+	while(row--)
+	{
+		const tBtnTransition *ptran = &tblTransitions[row];
+		if((ptran->CurrentState >= kBtnNumStates) || (ptran->Reason3 >= kNumReasons)) { continue; }
+		pcell = &tblDispatch[ptran->CurrentState][Reason1Slot(ptran->Reason1)][ptran->Reason3];
+		tblDispatchChain[row] = *pcell;
+		*pcell = (uint8_t)(row + 1);
+	}
+	dispatchready = true;
+}
+
+/** Run one step of one button's state machine.
+ *	Same contract as the library SME: the state handler is called once; when it reports it has
+ *	finished its exit action, the transition matching its exit reasons is taken, and its transition
+ *	function is called. A Reason2 of 0xFF in the table matches any button.
+ *
+ *	@returns the state to run on the next step, or #kBtnStateNone if no transition matched.
+ */
+static uint8_t
+Btn_Sme(uint8_t currentstate, tEvQ_Event ev, uint32_t extra)
+{
+	const tBtnTransition *ptran;
+	uint8_t row;
+#if (BTN_INSTRUMENTATION)
+	uint32_t thisbutton = ev.evData;	// the state handler rewrites evData w/ its exit reasons
+#endif
+
+	if(tblStates[currentstate](&ev, &extra) != kStateFinished)	{ return currentstate; }
+
+	row = (extra < kNumReasons) ? tblDispatch[currentstate][Reason1Slot(ev.evId)][extra] : 0;
+	while(row)
+	{
+		ptran = &tblTransitions[row - 1];
+		if((ptran->Reason1 == ev.evId) && ((ptran->Reason2 == 0xFF) || (ptran->Reason2 == ev.evData)))
+		{
+			if(ptran->Transition)	{ ptran->Transition(ev, extra); }
+#if (BTN_INSTRUMENTATION)
+			StatTransition(thisbutton, row - 1u, extra);
+#endif
+			return ptran->NextState;
+		}
+		row = tblDispatchChain[row - 1];
+	}
+	return kBtnStateNone;
+}
+#endif											/* } */
+
+
+#if (BTN_DEBOUNCE_ENGINE != BTN_ENGINE_SME)		/* { */
+// ============================================================================
+// ----	Whole-Word Debounce Engines -------------------------------------------
+// ============================================================================
+
+#if (BTN_EARLY_PRESS)
+/** Cancel the tentative presses of one word's buttons, as decided by the engine. */
+static void
+NotifyEarlyCancels(uint32_t idxword, tBoardButtonMap cancels)
+{
+	uint32_t idxbutton = idxword * BOARD_BUTTON_MAP_WORD_BITS;
+	for( ; cancels; cancels >>= 1, ++idxbutton)
+	{
+		if(cancels & 1)	{ NotifyEarlyPress(evButton_PressCancelled, idxbutton); }
+	}
+}
+#endif
+
+/** Apply one word's debounced changes, and run the stuck timers of the buttons being held.
+ *	Only buttons whose debounced state changed, or that are being held, are visited individually;
+ *	the notifications are the same as the SME's transitions, and go through NotifyBtnStateChg.
+ */
+static void
+NotifyDebouncedWord(tEvQ_Event ev, uint32_t idxword, tBoardButtonMap changed)
+{
+	tBoardButtonMap held, bits;
+	tCwswClockTics tmrBtnDeadline;
+	uint32_t idxbit, idxbutton;
+
+#if (BTN_INSTRUMENTATION)
+	// a press starts w/ the first "1" seen while released; it is forgotten once the engine has
+	//	settled back on released (vertical: the run was broken; timestamp: the quiet time passed).
+	held = pBtn->btnInputs[idxword] | pBtn->btnDebounced[idxword];
+#if (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_TIMESTAMP)
+	held |= pBtn->btnPending[idxword];
+#endif
+	pBtn->btnTwitchArmed[idxword] &= held;
+	idxbutton = idxword * BOARD_BUTTON_MAP_WORD_BITS;
+	for(bits = pBtn->btnInputs[idxword] & ~pBtn->btnDebounced[idxword] & ~pBtn->btnTwitchArmed[idxword]; bits; bits >>= 1, ++idxbutton)
+	{
+		if(bits & 1)	{ StatTwitch(idxbutton); }
+	}
+#endif
+
+#if (BTN_EARLY_PRESS)
+	// tentative press on the first "1" seen while released
+	idxbutton = idxword * BOARD_BUTTON_MAP_WORD_BITS;
+	for(bits = pBtn->btnInputs[idxword] & ~pBtn->btnDebounced[idxword] & ~pBtn->btnTentative[idxword]; bits; bits >>= 1, ++idxbutton)
+	{
+		if(bits & 1)	{ NotifyEarlyPress(evButton_EarlyPress, idxbutton); }
+	}
+#endif
+
+	pBtn->btnDebounced[idxword] ^= changed;
+
+	held = pBtn->btnDebounced[idxword] & ~pBtn->btnStuck[idxword];
+	idxbutton = idxword * BOARD_BUTTON_MAP_WORD_BITS;
+	for(bits = changed | held, idxbit = 0; bits; bits >>= 1, ++idxbit, ++idxbutton)
+	{
+		if(!(bits & 1))	{ continue; }
+
+		ev.evData = idxbutton;
+		if((changed >> idxbit) & 1)
+		{
+			if(BTNMAP_TEST(pBtn->btnDebounced, idxbutton))
+			{
+				ev.evId = evBntPressed;
+				Set(Cwsw_Clock, pBtn->tmrStuck[idxbutton], BtnCalStuckTime(idxbutton));
+#if (BTN_INSTRUMENTATION)
+				StatPressed(idxbutton);
+				StatEnter(idxbutton, kBtnStatPressed);
+#endif
+#if (BTN_EARLY_PRESS)
+				NotifyEarlyPress(evButton_PressConfirmed, idxbutton);
+#endif
+				NotifyBtnStateChg(ev, kReasonDebounced);
+			}
+			else if(BTNMAP_TEST(pBtn->btnStuck, idxbutton))
+			{
+				// stuck buttons report "unstuck" rather than "released", same as the SME.
+				BTNMAP_CLR(pBtn->btnStuck, idxbutton);
+#if (BTN_INSTRUMENTATION)
+				StatEnter(idxbutton, kBtnStatReleased);
+#endif
+				NotifyBtnStateChg(ev, kReasonButtonUnstuck);
+			}
+			else
+			{
+				ev.evId = evBtnReleased;
+#if (BTN_INSTRUMENTATION)
+				StatEnter(idxbutton, kBtnStatReleased);
+#endif
+				NotifyBtnStateChg(ev, kReasonDebounced);
+			}
+		}
+		else
+		{
+			// TM() API doesn't work w/ array syntax; copy to local scalar timer
+			tmrBtnDeadline = pBtn->tmrStuck[idxbutton];
+			if(TM(tmrBtnDeadline))
+			{
+				BTNMAP_SET(pBtn->btnStuck, idxbutton);
+#if (BTN_INSTRUMENTATION)
+				StatEnter(idxbutton, kBtnStatStuck);
+#endif
+				NotifyBtnStateChg(ev, kReasonTimeout);
+			}
+#if (BTN_GESTURES)
+			else
+			{
+				GestureHeld(idxbutton, Cwsw_GetTimeLeft(tmrBtnDeadline));
+			}
+#endif
+		}
+	}
+}
+#endif											/* } */
+
+
+#if (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_VERTICAL)	/* { */
+// ============================================================================
+// ----	Vertical-Counter Debounce Engine --------------------------------------
+// ============================================================================
+
+#if defined(BTN_CALIBRATION_TABLE)
+/** Lay out every button's calibrated sample count as the threshold bit planes. */
+static void
+BuildVcThresholds(void)
+{
+	uint32_t idx, n;
+
+	for(idx = 0; idx < kBoardNumButtons; ++idx)
+	{
+		n = BtnCalSamples(idx);
+		if(n & 1)	{ BTNMAP_SET(vcthr0, idx); }
+		if(n & 2)	{ BTNMAP_SET(vcthr1, idx); }
+		if(n & 4)	{ BTNMAP_SET(vcthr2, idx); }
+	}
+	vcthrready = true;
+}
+#endif
+
+/** Debounce all buttons in one pass.
+ *	Each button's 3-bit vertical counter advances while its input disagrees with its debounced
+ *	state, and clears as soon as the two agree. when the counter reaches the button's calibrated
+ *	sample count (8, by default, wraps it to 0; the same run length as the SME's test), the
+ *	debounced state toggles.
+ *
+ *	Only buttons whose debounced state changed, or that are being held, are visited individually.
+ */
+static void
+VcDebounceAllButtons(tEvQ_Event ev)
+{
+	tBoardButtonMap delta, changed;
+	uint32_t idxword;
+#if (BTN_EARLY_PRESS)
+	tBoardButtonMap quiet, cancelled;
+#endif
+
+#if defined(BTN_CALIBRATION_TABLE)
+	if(!vcthrready)	{ BuildVcThresholds(); }
+#endif
+	for(idxword = 0; idxword < kBoardNumButtonWords; ++idxword)
+	{
+		delta = pBtn->btnInputs[idxword] ^ pBtn->btnDebounced[idxword];
+
+		// increment counters where input differs from the debounced state, clear them elsewhere
+		pBtn->vcnt2[idxword] = (pBtn->vcnt2[idxword] ^ (pBtn->vcnt1[idxword] & pBtn->vcnt0[idxword])) & delta;
+		pBtn->vcnt1[idxword] = (pBtn->vcnt1[idxword] ^ pBtn->vcnt0[idxword]) & delta;
+		pBtn->vcnt0[idxword] = ~pBtn->vcnt0[idxword] & delta;
+
+		// counter reached the threshold while still disagreeing: accept new state
+		changed = delta & ~((pBtn->vcnt2[idxword] ^ VcThreshold(2, idxword)) |
+							(pBtn->vcnt1[idxword] ^ VcThreshold(1, idxword)) |
+							(pBtn->vcnt0[idxword] ^ VcThreshold(0, idxword)));
+
+		// a run shorter than 8 leaves its count behind; restart it, so a bounce right after the
+		// new state is accepted needs a full run of its own
+		pBtn->vcnt2[idxword] &= ~changed;
+		pBtn->vcnt1[idxword] &= ~changed;
+		pBtn->vcnt0[idxword] &= ~changed;
+
+#if (BTN_EARLY_PRESS)
+		// a tentative press is cancelled by a run of "0" samples as long as the one that accepts a press
+		quiet = pBtn->btnTentative[idxword] & ~pBtn->btnInputs[idxword];
+		pBtn->vzcnt2[idxword] = (pBtn->vzcnt2[idxword] ^ (pBtn->vzcnt1[idxword] & pBtn->vzcnt0[idxword])) & quiet;
+		pBtn->vzcnt1[idxword] = (pBtn->vzcnt1[idxword] ^ pBtn->vzcnt0[idxword]) & quiet;
+		pBtn->vzcnt0[idxword] = ~pBtn->vzcnt0[idxword] & quiet;
+		cancelled = quiet & ~((pBtn->vzcnt2[idxword] ^ VcThreshold(2, idxword)) |
+							  (pBtn->vzcnt1[idxword] ^ VcThreshold(1, idxword)) |
+							  (pBtn->vzcnt0[idxword] ^ VcThreshold(0, idxword)));
+		pBtn->vzcnt2[idxword] &= ~cancelled;
+		pBtn->vzcnt1[idxword] &= ~cancelled;
+		pBtn->vzcnt0[idxword] &= ~cancelled;
+		NotifyEarlyCancels(idxword, cancelled);
+#endif
+		NotifyDebouncedWord(ev, idxword, changed);
+	}
+}
+#endif												/* } */
+
+
+#if (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_TIMESTAMP)	/* { */
+// ============================================================================
+// ----	Edge-Timestamp Debounce Engine ----------------------------------------
+// ============================================================================
+
+/** Debounce all buttons from the times of their edges.
+ *	An edge is a change in a button's sampled input, stamped w/ the sample time; or, on boards that
+ *	set BOARD_BUTTON_EDGE_TIMES, an edge the board captured, w/ the board's (finer) timestamp. Once
+ *	#BTN_QUIET_TIME has passed since a button's last edge, its input level is accepted.
+ *
+ *	There is no per-sample shift work: a word of stable, released buttons costs two word operations.
+ */
+static void
+TsDebounceAllButtons(tEvQ_Event ev)
+{
+	tCwswClockTics now = Get(Cwsw_Clock, Now);
+	tBoardButtonMap edges, stamp, changed, bits;
+	uint32_t idxword, idxbutton;
+#if (BOARD_BUTTON_EDGE_TIMES)
+	tBoardButtonMap captured[kBoardNumButtonWords];
+
+	// the board writes the times of the edges it captured straight into the instance's btnEdgeTime[]
+	di_read_button_edge_times(captured, pBtn->btnEdgeTime);
+#endif
+
+	for(idxword = 0; idxword < kBoardNumButtonWords; ++idxword)
+	{
+		edges = pBtn->btnInputs[idxword] ^ pBtn->btnLastSample[idxword];
+		pBtn->btnLastSample[idxword] = pBtn->btnInputs[idxword];
+		stamp = edges;
+#if (BOARD_BUTTON_EDGE_TIMES)
+		stamp &= ~captured[idxword];		// captured edges already have a better timestamp
+		edges |= captured[idxword];
+#endif
+		idxbutton = idxword * BOARD_BUTTON_MAP_WORD_BITS;
+		for(bits = stamp; bits; bits >>= 1, ++idxbutton)
+		{
+			if(bits & 1)	{ pBtn->btnEdgeTime[idxbutton] = now; }
+		}
+		pBtn->btnPending[idxword] |= edges;
+
+		// pending buttons that have been quiet long enough settle at their current input level
+		changed = 0;
+		idxbutton = idxword * BOARD_BUTTON_MAP_WORD_BITS;
+		for(bits = pBtn->btnPending[idxword]; bits; bits >>= 1, ++idxbutton)
+		{
+			if(!(bits & 1))									{ continue; }
+			if((now - pBtn->btnEdgeTime[idxbutton]) < BTN_QUIET_TIME)	{ continue; }
+
+			BTNMAP_CLR(pBtn->btnPending, idxbutton);
+			if(BTNMAP_TEST(pBtn->btnInputs, idxbutton) != BTNMAP_TEST(pBtn->btnDebounced, idxbutton))
+			{
+				changed |= (tBoardButtonMap)1 << (idxbutton % BOARD_BUTTON_MAP_WORD_BITS);
+			}
+		}
+#if (BTN_EARLY_PRESS)
+		// a tentative press is cancelled once its button settles back on released
+		NotifyEarlyCancels(idxword, pBtn->btnTentative[idxword] & ~pBtn->btnInputs[idxword] & ~pBtn->btnDebounced[idxword] & ~pBtn->btnPending[idxword]);
+#endif
+		NotifyDebouncedWord(ev, idxword, changed);
+	}
+}
+#endif											/* } */
+
 
 // ============================================================================
 // ----	Public Functions ------------------------------------------------------
@@ -506,33 +1682,282 @@ static tTransitionTable tblTransitions[] = {
  *	we add support for more boards.
  *
  *	This handler needs to make the adaptation between our array of button state machines (one SM for
- *	each button), and the single-instance SME.
+ *	each button), and the single-instance SME. Transitions are resolved through an index built from
+ *	the transition table on the first call, so each step costs one lookup regardless of table size.
+ *
+ *	Buttons resting in the Released state are pBtn->btnParked, and skipped, until their input reads
+ *	"pressed" or the DI layer reports activity on them; scan cost follows the active inputs, not
+ *	the total number of inputs. Stuck buttons park the same way, until their input reads
+ *	"released", so a wedged key neither costs a state step per tick nor holds the scan at its fast
+ *	rate.
+ *
+ *	When #BTN_DEBOUNCE_ENGINE is #BTN_ENGINE_VERTICAL or #BTN_ENGINE_TIMESTAMP, the per-button SMs
+ *	are not used; all buttons are debounced together each tick.
+ *
+ *	When every button is at rest (in Released, or parked in Stuck), the task drops its own alarm to
+ *	#BTN_SCAN_IDLE_PERIOD (if the project set one), and returns to #BTN_SCAN_PERIOD as soon as any
+ *	button has something to do.
  */
 void
 Btn_tsk_ButtonRead(tEvQ_Event ev, uint32_t extra)	// uses DI lower layers
 {
-	static pfStateHandler currentstate[kBoardNumButtons] = {NULL};
-	uint32_t idxbutton = TABLE_SIZE(currentstate);
+	tBoardButtonMap busy = 0;		// nonzero if any button is anywhere but at rest in Released
+	uint32_t idxword;
+#if (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_SME)
+	tBoardButtonMap scan[kBoardNumButtonWords];
+	tBoardButtonMap bits;
+	uint32_t idxbutton;
+	tBtnContext *pctx;
+	uint8_t prevstate;
+
+	// buttons the DI layer saw change since the last scan; read before sampling, so nothing is lost
+	di_read_button_activity(scan);
+#endif
+
+	// one DI sample per tick, seen by every button
+	di_read_button_inputs(pBtn->btnInputs);
+#if (BTN_TRACE)
+	TraceInputs();
+#endif
+
+#if (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_VERTICAL)
+	UNUSED(extra);
+	VcDebounceAllButtons(ev);
 
-	while(idxbutton--)
+	/* at rest: nothing pressed, and nothing on its way to being pressed or released. a stuck
+	 * button is at rest until its input moves.
+	 */
+	for(idxword = 0; idxword < kBoardNumButtonWords; ++idxword)
 	{
-		if(!currentstate[idxbutton])	{ currentstate[idxbutton] = stStart; }
+		busy |= ((pBtn->btnInputs[idxword] | pBtn->btnDebounced[idxword]) & ~pBtn->btnStuck[idxword]) |
+				(pBtn->btnInputs[idxword] ^ pBtn->btnDebounced[idxword]);
+	}
 
-		ev.evData = idxbutton;
-		currentstate[idxbutton] = Cwsw_Sme__SME(
-				tblTransitions, TABLE_SIZE(tblTransitions),
-				currentstate[idxbutton], ev, extra);
+#elif (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_TIMESTAMP)
+	UNUSED(extra);
+	TsDebounceAllButtons(ev);
+
+	// at rest: nothing pressed, and no edge still waiting out its quiet time. a stuck button is at
+	//	rest until its input moves.
+	for(idxword = 0; idxword < kBoardNumButtonWords; ++idxword)
+	{
+		busy |= ((pBtn->btnInputs[idxword] | pBtn->btnDebounced[idxword]) & ~pBtn->btnStuck[idxword]) |
+				(pBtn->btnInputs[idxword] ^ pBtn->btnDebounced[idxword]) | pBtn->btnPending[idxword];
+	}
 
-		if(!currentstate[idxbutton])
+#else
+	if(!dispatchready)	{ BuildDispatchIndex(); }
+
+	for(idxword = 0; idxword < kBoardNumButtonWords; ++idxword)
+	{
+		/* a parked button only needs attention when its input leaves the level it parked at
+		 * ("pressed" for Released, "released" for Stuck), or when the DI layer flags activity on
+		 * it. everything else is mid-SM and gets stepped. a word of parked, quiet buttons is
+		 * skipped outright.
+		 */
+		bits = scan[idxword] | ~pBtn->btnParked[idxword] | (pBtn->btnInputs[idxword] ^ pBtn->btnParkedLevel[idxword]);
+		idxbutton = idxword * BOARD_BUTTON_MAP_WORD_BITS;
+		for( ; bits && (idxbutton < kBoardNumButtons); bits >>= 1, ++idxbutton)
+		{
+			if(!(bits & 1))		{ continue; }
+			pctx = &pBtn->btnContext[idxbutton];
+			if(!pctx->state)	{ pctx->state = kBtnStateStart; }
+
+			ev.evData = idxbutton;
+			prevstate = pctx->state;
+			pctx->state = Btn_Sme(pctx->state, ev, extra);
+#if (BTN_TRACE)
+			if(prevstate != pctx->state)	{ TraceRecord(kBtnTraceState, idxbutton, pctx->state); }
+#endif
+
+			/* Released w/ a "0" input, and Stuck w/ a "1" input, once their entry actions are done,
+			 * only repeat themselves until the input changes: park them. the other input level means
+			 * the state is on its way out; keep stepping.
+			 */
+			if((prevstate == pctx->state) &&
+			   (((pctx->state == kBtnStateReleased) && !BTNMAP_TEST(pBtn->btnInputs, idxbutton)) ||
+				((pctx->state == kBtnStateStuck) && BTNMAP_TEST(pBtn->btnInputs, idxbutton))))
+			{
+				BTNMAP_SET(pBtn->btnParked, idxbutton);
+				if(pctx->state == kBtnStateStuck)	{ BTNMAP_SET(pBtn->btnParkedLevel, idxbutton); }
+				else								{ BTNMAP_CLR(pBtn->btnParkedLevel, idxbutton); }
+			}
+			else
+			{
+				BTNMAP_CLR(pBtn->btnParked, idxbutton);
+			}
+
+			if(!pctx->state)
+			{
+				// disable alarm that launches this SME via its event.
+				//	if restarted, we'll resume in the current state
+				//	need a way to restart w/ the init state.
+				pBtn->ptmr->tmrstate = kTmrState_Disabled;
+			}
+		}	// idxbutton
+
+		// bits past the last button don't exist, and count as parked
+		bits = ~pBtn->btnParked[idxword];
+		if((idxword + 1) * BOARD_BUTTON_MAP_WORD_BITS > kBoardNumButtons)
 		{
-			// disable alarm that launches this SME via its event.
-			//	if restarted, we'll resume in the current state
-			//	need a way to restart w/ the init state.
-			Btn_tmr_ButtonRead.tmrstate = kTmrState_Disabled;
+			bits &= ((tBoardButtonMap)1 << (kBoardNumButtons % BOARD_BUTTON_MAP_WORD_BITS)) - 1;
 		}
-	}	// idxbutton
+		busy |= bits;
+	}	// idxword
+#endif
+
+	SetScanPeriod(busy ? BTN_SCAN_PERIOD : BTN_SCAN_IDLE_PERIOD);
+
+#if (BTN_BATCH_EVENTS)
+	PostBtnBatch();
+#endif
+}
+
+
+#if (BTN_BATCH_EVENTS)
+tBtnBatch const *
+Btn_GetBatch(uint32_t seq)
+{
+	tBtnBatch const *pbatch = &pBtn->btnBatches[seq % BTN_BATCH_DEPTH];
+	return (seq && (pbatch->seq == seq)) ? pbatch : NULL;
+}
+#endif
+
+tBtnInstance *
+Btn_NewInstance(void)
+{
+	tBtnInstance *pinst;
+
+	if(btnInstancesUsed >= BTN_MAX_INSTANCES)	{ return NULL; }
+	pinst = &btnInstances[btnInstancesUsed++];
+
+	pinst->ptmr = &pinst->tmr;
+	pinst->tmr.tm = BTN_SCAN_PERIOD;
+	pinst->tmr.reloadtm = BTN_SCAN_PERIOD;
+	pinst->tmr.tmrstate = kTmrState_Enabled;
+	pinst->btnScanPeriod = BTN_SCAN_PERIOD;
+
+	// tables shared by every instance are built now, rather than by whichever task runs first
+#if (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_SME)
+	if(!dispatchready)	{ BuildDispatchIndex(); }
+#elif (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_VERTICAL) && defined(BTN_CALIBRATION_TABLE)
+	if(!vcthrready)		{ BuildVcThresholds(); }
+#endif
+	return pinst;
+}
+
+tBtnInstance *
+Btn_SelectInstance(tBtnInstance *pinst)
+{
+	tBtnInstance *pprev = pBtn;
+	pBtn = pinst ? pinst : &btnInstances[0];
+	return pprev;
 }
 
+void
+Btn_Wake(void)
+{
+	SetScanPeriod(BTN_SCAN_PERIOD);
+}
+
+tCwswClockTics
+Cwsw_Board__Get_BtnScanPeriod(void)
+{
+	return pBtn->btnScanPeriod;
+}
+
+tCwswSwAlarm *
+Cwsw_Board__Get_BtnAlarm(void)
+{
+	return pBtn->ptmr;
+}
+
+uint32_t
+Cwsw_Board__Get_BtnEventsPosted(void)
+{
+	return pBtn->btnEventsPosted;
+}
+
+uint32_t
+Cwsw_Board__Get_BtnEventsDropped(void)
+{
+	return pBtn->btnEventsDropped;
+}
+
+#if (BTN_INSTRUMENTATION)
+tBtnStats const *
+Cwsw_Board__Get_BtnStats(void)
+{
+	return &pBtn->btnStats;
+}
+
+void
+Btn_ResetStats(void)
+{
+	static const tBtnStats nostats = {{{0}}, {0}, {0}, 0, 0};
+	tCwswClockTics now = Get(Cwsw_Clock, Now);
+	uint32_t idx;
+
+	pBtn->btnStats = nostats;
+	for(idx = 0; idx < kBoardNumButtons; ++idx)	{ pBtn->btnStatEntered[idx] = now; }
+}
+#endif
+
+#if (BTN_TRACE)
+size_t
+Btn_TraceSize(void)
+{
+	size_t records = pBtn->btnTraceCount;
+	uint32_t idx;
+
+	// buttons already pressed when the window opens each need a record up front
+	for(idx = 0; idx < kBoardNumButtons; ++idx)
+	{
+		if(BTNMAP_TEST(pBtn->btnTraceBase, idx))	{ ++records; }
+	}
+	return 8 + 8 * records;
+}
+
+size_t
+Btn_TraceFlush(void *pbuf, size_t size)
+{
+	size_t need = Btn_TraceSize();
+	uint8_t *p = (uint8_t *)pbuf;
+	tBtnTraceEntry const *pent;
+	tCwswClockTics prev;
+	uint32_t idx, slot;
+
+	if(!p || (size < need))	{ return 0; }
+
+	// header: magic, version, reserved, button count
+	p[0] = 'C'; p[1] = 'W'; p[2] = 'B'; p[3] = 'R';
+	p[4] = 1;
+	p[5] = 0;
+	p[6] = (uint8_t)kBoardNumButtons;
+	p[7] = (uint8_t)(kBoardNumButtons >> 8);
+	p += 8;
+
+	for(idx = 0; idx < kBoardNumButtons; ++idx)
+	{
+		if(BTNMAP_TEST(pBtn->btnTraceBase, idx))	{ p = WrTraceRecord(p, 0, (uint16_t)idx, 1, kBtnTraceInput); }
+	}
+
+	slot = (pBtn->btnTraceHead - pBtn->btnTraceCount) & (BTN_TRACE_DEPTH - 1);
+	prev = pBtn->btnTrace[slot].tm - BTN_TRACE_LEAD_IN;
+	for(idx = 0; idx < pBtn->btnTraceCount; ++idx, slot = (slot + 1) & (BTN_TRACE_DEPTH - 1))
+	{
+		pent = &pBtn->btnTrace[slot];
+		p = WrTraceRecord(p, (uint32_t)(pent->tm - prev), pent->id, pent->level, pent->kind);
+		prev = pent->tm;
+	}
+
+	// drained: the next window starts from the inputs as they stand now
+	pBtn->btnTraceCount = 0;
+	for(idx = 0; idx < kBoardNumButtonWords; ++idx)	{ pBtn->btnTraceBase[idx] = pBtn->btnTraceLevel[idx]; }
+	return need;
+}
+#endif
+
 
 /** Set button event parameters.
  */
@@ -540,8 +1965,26 @@ void
 Btn_SetQueue(tEvQ_EventID const evId, const ptEvQ_QueueCtrlEx pEvqx)
 {
 	// set queue for button activity
-	pBtnEvqx = pEvqx;
+	Btn_SetEventQueue(pEvqx);
 	// set parameters for timer expiration notifications
-	Btn_tmr_ButtonRead.pEvQX = pEvqx;
-	Btn_tmr_ButtonRead.evid = evId;
+	Btn_SetAlarmQueue(evId, pEvqx);
+}
+
+void
+Btn_SetAlarmQueue(tEvQ_EventID const evId, const ptEvQ_QueueCtrlEx pEvqx)
+{
+	pBtn->ptmr->pEvQX = pEvqx;
+	pBtn->ptmr->evid = evId;
+}
+
+void
+Btn_SetEventQueue(const ptEvQ_QueueCtrlEx pEvqx)
+{
+	pBtn->pBtnEvqx = pEvqx;
+}
+
+void
+Btn_SetPriorityQueue(const ptEvQ_QueueCtrlEx pEvqx)
+{
+	pBtn->pBtnPriorityEvqx = pEvqx;
 }
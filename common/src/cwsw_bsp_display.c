@@ -0,0 +1,144 @@
+/** @file
+ *	@brief	Back buffer, w/ dirty-span tracking, for a board's text display.
+ *
+ *	Each line keeps a single span, from its first to its last changed column: two edits at either
+ *	end of a line are pushed as one span covering both, which is still one update of one line.
+ *
+ *	\copyright
+ *	Copyright (c) 2026 agent. All rights reserved.
+ *
+ *	Created on: Oct 14, 2026
+ *	@author agent
+ */
+
+// ============================================================================
+// ----	Include Files ---------------------------------------------------------
+// ============================================================================
+
+// ----	System Headers --------------------------
+#include <string.h>
+
+// ----	Project Headers -------------------------
+#include "cwsw_lib.h"
+
+// ----	Module Headers --------------------------
+#include "cwsw_bsp_display.h"
+
+
+// ============================================================================
+// ----	Constants -------------------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Type Definitions ------------------------------------------------------
+// ============================================================================
+
+/// compile-time checks: a line's span fits its bytes, and the dirty lines fit their bitmap.
+typedef char tDisplayColsFit[((BOARD_DISPLAY_COLS >= 1) && (BOARD_DISPLAY_COLS <= 255)) ? 1 : -1];
+typedef char tDisplayRowsFit[((BOARD_DISPLAY_ROWS >= 1) && (BOARD_DISPLAY_ROWS <= 32)) ? 1 : -1];
+
+
+// ============================================================================
+// ----	Global Variables ------------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Module-level Variables ------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Private Functions -----------------------------------------------------
+// ============================================================================
+
+/// Widen line `row`'s dirty span to take in columns `lo` .. `hi`.
+static void
+MarkDirty(tBoardDisplay *pdisp, uint32_t row, uint32_t lo, uint32_t hi)
+{
+	if(!BIT_TEST(pdisp->dirtyrows, row))
+	{
+		BIT_SET(pdisp->dirtyrows, row);
+		pdisp->dirtylo[row] = (uint8_t)lo;
+		pdisp->dirtyhi[row] = (uint8_t)hi;
+		return;
+	}
+	if(lo < pdisp->dirtylo[row])	{ pdisp->dirtylo[row] = (uint8_t)lo; }
+	if(hi > pdisp->dirtyhi[row])	{ pdisp->dirtyhi[row] = (uint8_t)hi; }
+}
+
+
+// ============================================================================
+// ----	Public Functions ------------------------------------------------------
+// ============================================================================
+
+void
+di_display_init(tBoardDisplay *pdisp)
+{
+	uint32_t row;
+
+	if(!pdisp)	{ return; }
+	memset(pdisp->text, ' ', sizeof(pdisp->text));
+	pdisp->dirtyrows = 0;
+	for(row = 0; row < BOARD_DISPLAY_ROWS; ++row)	{ MarkDirty(pdisp, row, 0, BOARD_DISPLAY_COLS - 1); }
+}
+
+bool
+di_display_write(tBoardDisplay *pdisp, uint32_t row, uint32_t col, const char *text, size_t len)
+{
+	uint32_t lo = BOARD_DISPLAY_COLS, hi = 0;
+	char *pcell;
+	char ch;
+
+	if(!pdisp || !text || (row >= BOARD_DISPLAY_ROWS) || (col >= BOARD_DISPLAY_COLS))	{ return false; }
+	if(len > BOARD_DISPLAY_COLS - col)	{ len = BOARD_DISPLAY_COLS - col; }
+
+	for(pcell = &pdisp->text[row][col]; len && *text; --len, ++text, ++pcell, ++col)
+	{
+		ch = ((*text >= ' ') && (*text <= '~')) ? *text : '?';
+		if(*pcell == ch)	{ continue; }
+		*pcell = ch;
+		if(col < lo)	{ lo = col; }
+		hi = col;
+	}
+
+	if(lo > hi)	{ return false; }
+	MarkDirty(pdisp, row, lo, hi);
+	return true;
+}
+
+bool
+di_display_clear(tBoardDisplay *pdisp)
+{
+	uint32_t row, col, lo, hi;
+	bool changed = false;
+
+	if(!pdisp)	{ return false; }
+	for(row = 0; row < BOARD_DISPLAY_ROWS; ++row)
+	{
+		for(lo = BOARD_DISPLAY_COLS, hi = 0, col = 0; col < BOARD_DISPLAY_COLS; ++col)
+		{
+			if(pdisp->text[row][col] == ' ')	{ continue; }
+			pdisp->text[row][col] = ' ';
+			if(col < lo)	{ lo = col; }
+			hi = col;
+		}
+		if(lo > hi)	{ continue; }
+		MarkDirty(pdisp, row, lo, hi);
+		changed = true;
+	}
+	return changed;
+}
+
+void
+di_display_flush(tBoardDisplay *pdisp, pfBoardDisplaySpan pfshow)
+{
+	uint32_t row, lo;
+
+	if(!pdisp || !pfshow)	{ return; }
+	for(row = 0; pdisp->dirtyrows; ++row)
+	{
+		if(!BIT_TEST(pdisp->dirtyrows, row))	{ continue; }
+		BIT_CLR(pdisp->dirtyrows, row);
+		lo = pdisp->dirtylo[row];
+		pfshow(row, lo, &pdisp->text[row][lo], (uint32_t)pdisp->dirtyhi[row] - lo + 1);
+	}
+}
@@ -0,0 +1,145 @@
+/** @file
+ *	@brief	Single-producer / single-consumer ring of timestamped button edges.
+ *
+ *	The producer publishes a slot by storing `head` with release semantics after the slot is
+ *	written; the consumer frees it by storing `tail` with release semantics after the slot is read.
+ *	Each side loads the other side's index with acquire semantics.
+ *
+ *	\copyright
+ *	Copyright (c) 2026 agent. All rights reserved.
+ *
+ *	Created on: Oct 14, 2026
+ *	@author agent
+ */
+
+// ============================================================================
+// ----	Include Files ---------------------------------------------------------
+// ============================================================================
+
+// ----	System Headers --------------------------
+
+// ----	Project Headers -------------------------
+#include "cwsw_lib.h"
+
+// ----	Module Headers --------------------------
+#include "cwsw_bsp_edgering.h"
+
+
+// ============================================================================
+// ----	Constants -------------------------------------------------------------
+// ============================================================================
+
+#define kEdgeRingMask	(BOARD_EDGE_RING_DEPTH - 1)
+
+/** Index accessors.
+ *	W/out C11 atomics, fall back to a full fence around a volatile access; on a single-threaded
+ *	build (e.g., LabWindows/CVI's UI loop) the fence is harmless.
+ *	@{
+ */
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#define EDGE_LOAD_OWN(idx)			atomic_load_explicit(&(idx), memory_order_relaxed)
+#define EDGE_LOAD_ACQUIRE(idx)		atomic_load_explicit(&(idx), memory_order_acquire)
+#define EDGE_STORE_RELEASE(idx, v)	atomic_store_explicit(&(idx), (v), memory_order_release)
+#else
+#if defined(__GNUC__)
+#define EDGE_FENCE()				__sync_synchronize()
+#else
+#define EDGE_FENCE()
+#endif
+#define EDGE_LOAD_OWN(idx)			(idx)
+#define EDGE_LOAD_ACQUIRE(idx)		edge_load_acquire(&(idx))
+#define EDGE_STORE_RELEASE(idx, v)	do { EDGE_FENCE(); (idx) = (v); } while(0)
+#endif
+/** @} */
+
+
+// ============================================================================
+// ----	Type Definitions ------------------------------------------------------
+// ============================================================================
+
+/// compile-time check: free-running indices wrap cleanly only for a power-of-2 depth.
+typedef char tEdgeRingDepthIsPow2[((BOARD_EDGE_RING_DEPTH & kEdgeRingMask) == 0) ? 1 : -1];
+
+
+// ============================================================================
+// ----	Global Variables ------------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Module-level Variables ------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Private Functions -----------------------------------------------------
+// ============================================================================
+
+#if !(defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__))
+static uint32_t
+edge_load_acquire(tBoardEdgeIndex *pidx)
+{
+	uint32_t v = *pidx;
+	EDGE_FENCE();
+	return v;
+}
+#endif
+
+
+// ============================================================================
+// ----	Public Functions ------------------------------------------------------
+// ============================================================================
+
+bool
+di_edge_push(tBoardEdgeRing *pring, uint16_t button, bool level)
+{
+	uint32_t head;
+	tBoardEdge *pedge;
+
+	if(!pring)	{ return false; }
+
+	head = EDGE_LOAD_OWN(pring->head);
+	if((uint32_t)(head - EDGE_LOAD_ACQUIRE(pring->tail)) >= BOARD_EDGE_RING_DEPTH)
+	{
+		++pring->overruns;
+		return false;
+	}
+
+	pedge = &pring->edges[head & kEdgeRingMask];
+	pedge->tm		= Get(Cwsw_Clock, Now);
+	pedge->button	= button;
+	pedge->level	= level ? 1 : 0;
+	EDGE_STORE_RELEASE(pring->head, head + 1);
+	return true;
+}
+
+bool
+di_edge_peek(tBoardEdgeRing *pring, tBoardEdge *pedge)
+{
+	uint32_t tail;
+
+	if(!pring || !pedge)	{ return false; }
+
+	tail = EDGE_LOAD_OWN(pring->tail);
+	if(tail == EDGE_LOAD_ACQUIRE(pring->head))	{ return false; }
+
+	*pedge = pring->edges[tail & kEdgeRingMask];
+	return true;
+}
+
+void
+di_edge_pop(tBoardEdgeRing *pring)
+{
+	uint32_t tail;
+
+	if(!pring)	{ return; }
+
+	tail = EDGE_LOAD_OWN(pring->tail);
+	if(tail == EDGE_LOAD_ACQUIRE(pring->head))	{ return; }
+	EDGE_STORE_RELEASE(pring->tail, tail + 1);
+}
+
+bool
+di_edge_pending(tBoardEdgeRing *pring)
+{
+	if(!pring)	{ return false; }
+	return EDGE_LOAD_OWN(pring->tail) != EDGE_LOAD_ACQUIRE(pring->head);
+}
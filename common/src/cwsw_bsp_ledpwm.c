@@ -0,0 +1,94 @@
+/** @file
+ *	@brief	Software PWM (dimming) for a board's bitmapped LEDs.
+ *
+ *	LED `n` w/ duty `d` is lit on tick `t` when `(t * d) mod STEPS >= STEPS - d`: exactly `d` of
+ *	every STEPS consecutive ticks, spaced as evenly as integer ticks allow.
+ *
+ *	\copyright
+ *	Copyright (c) 2026 agent. All rights reserved.
+ *
+ *	Created on: Oct 14, 2026
+ *	@author agent
+ */
+
+// ============================================================================
+// ----	Include Files ---------------------------------------------------------
+// ============================================================================
+
+// ----	System Headers --------------------------
+
+// ----	Project Headers -------------------------
+#include "cwsw_lib.h"
+
+// ----	Module Headers --------------------------
+#include "cwsw_bsp_ledpwm.h"
+
+
+// ============================================================================
+// ----	Constants -------------------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Type Definitions ------------------------------------------------------
+// ============================================================================
+
+/// compile-time check: a duty is one byte.
+typedef char tLedPwmStepsFit[((BOARD_LED_PWM_STEPS >= 2) && (BOARD_LED_PWM_STEPS <= 255)) ? 1 : -1];
+
+
+// ============================================================================
+// ----	Global Variables ------------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Module-level Variables ------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Private Functions -----------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Public Functions ------------------------------------------------------
+// ============================================================================
+
+void
+di_led_pwm_set(tBoardLedPwm *ppwm, uint32_t led, uint8_t duty)
+{
+	if(!ppwm || (led >= kBoardLedPwmMaxLeds))	{ return; }
+
+	if(duty >= BOARD_LED_PWM_STEPS)
+	{
+		BIT_CLR(ppwm->dimmed, led);
+		ppwm->duty[led] = BOARD_LED_PWM_STEPS;
+	}
+	else
+	{
+		BIT_SET(ppwm->dimmed, led);
+		ppwm->duty[led] = duty;
+	}
+}
+
+uint32_t
+di_led_pwm_apply(tBoardLedPwm const *ppwm, uint32_t image, tCwswClockTics now)
+{
+	uint32_t dimmed, phase, led;
+	uint32_t out;
+
+	if(!ppwm)	{ return image; }
+	dimmed = ppwm->dimmed & image;
+	if(!dimmed)	{ return image; }
+
+	// LEDs that are off, or at full duty, pass through untouched
+	out = image & ~dimmed;
+	phase = (uint32_t)now % BOARD_LED_PWM_STEPS;
+	for(led = 0; dimmed; ++led, dimmed >>= 1)
+	{
+		if(!(dimmed & 1))	{ continue; }
+		if((phase * ppwm->duty[led]) % BOARD_LED_PWM_STEPS >= (uint32_t)(BOARD_LED_PWM_STEPS - ppwm->duty[led]))
+		{
+			BIT_SET(out, led);
+		}
+	}
+	return out;
+}
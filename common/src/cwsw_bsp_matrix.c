@@ -0,0 +1,145 @@
+/** @file
+ *	@brief	Matrix-keypad scan driver common to all boards.
+ *
+ *	Feeds the common button SM from a row-strobe / column-read keypad matrix. A full scan costs one
+ *	row strobe and one column read per row; a 16x16 keypad is 16 of each, per button-task tick.
+ *
+ *	\copyright
+ *	Copyright (c) 2026 agent. All rights reserved.
+ *
+ *	Created on: Oct 14, 2026
+ *	@author agent
+ */
+
+// ============================================================================
+// ----	Include Files ---------------------------------------------------------
+// ============================================================================
+
+// ----	System Headers --------------------------
+#include <stdbool.h>
+
+// ----	Project Headers -------------------------
+#include "cwsw_board.h"				// this module builds on top of the BSP
+
+// ----	Module Headers --------------------------
+#include "cwsw_bsp_matrix.h"		// public API for this module
+
+#if (BOARD_BUTTONS_MATRIX)			/* { */
+
+// ============================================================================
+// ----	Constants -------------------------------------------------------------
+// ============================================================================
+
+/// Mask of the column bits returned by di_matrix_read_columns().
+#define kMatrixColumnMask	\
+	((kBoardMatrixCols >= BOARD_BUTTON_MAP_WORD_BITS) ? \
+		(tBoardButtonMap)~(tBoardButtonMap)0 : (((tBoardButtonMap)1 << kBoardMatrixCols) - 1))
+
+
+// ============================================================================
+// ----	Type Definitions ------------------------------------------------------
+// ============================================================================
+
+/// compile-time checks: one row's columns fit in one word, and every key has a button ID.
+typedef char tMatrixColsFitInWord[(kBoardMatrixCols <= BOARD_BUTTON_MAP_WORD_BITS) ? 1 : -1];
+typedef char tMatrixKeysFitInButtons[
+	((kBoardMatrixFirstButton + (kBoardMatrixRows * kBoardMatrixCols)) <= kBoardNumButtons) ? 1 : -1];
+
+
+// ============================================================================
+// ----	Global Variables ------------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Module-level Variables ------------------------------------------------
+// ============================================================================
+
+/// Result of the previous scan, used to derive the "changed since last scan" mask.
+static tBoardButtonMap lastscan[kBoardNumButtonWords] = {0};
+
+/// Keys whose level changed since di_read_button_activity() was last called.
+static tBoardButtonMap keyactivity[kBoardNumButtonWords] = {0};
+
+
+// ============================================================================
+// ----	Private Functions -----------------------------------------------------
+// ============================================================================
+
+/** Merge one row's column bits into a bitmap, at the button ID of the row's 1st key.
+ *	A row may straddle two bitmap words.
+ */
+static void
+InsertRow(tBoardButtonMap *pmap, uint32_t firstbutton, tBoardButtonMap cols)
+{
+	uint32_t idxword	= firstbutton / BOARD_BUTTON_MAP_WORD_BITS;
+	uint32_t shift		= firstbutton % BOARD_BUTTON_MAP_WORD_BITS;
+
+	pmap[idxword] |= cols << shift;
+	if(shift && ((shift + kBoardMatrixCols) > BOARD_BUTTON_MAP_WORD_BITS))
+	{
+		pmap[idxword + 1] |= cols >> (BOARD_BUTTON_MAP_WORD_BITS - shift);
+	}
+}
+
+
+// ============================================================================
+// ----	Public Functions ------------------------------------------------------
+// ============================================================================
+
+/** Scan the keypad matrix; one strobe and one column read per row.
+ *	Button IDs outside the matrix always read "released".
+ */
+void
+di_read_button_inputs(tBoardButtonMap *pinputs)
+{
+	uint32_t row, idx;
+
+	if(!pinputs)	{ return; }
+	for(idx = 0; idx < kBoardNumButtonWords; ++idx)	{ pinputs[idx] = 0; }
+
+	for(row = 0; row < kBoardMatrixRows; ++row)
+	{
+		di_matrix_drive_row(row);
+		InsertRow(pinputs,
+				kBoardMatrixFirstButton + (row * kBoardMatrixCols),
+				di_matrix_read_columns() & kMatrixColumnMask);
+	}
+	di_matrix_release_rows();
+
+	// a matrix has no port-change notification of its own; derive it from successive scans
+	for(idx = 0; idx < kBoardNumButtonWords; ++idx)
+	{
+		keyactivity[idx] |= pinputs[idx] ^ lastscan[idx];
+		lastscan[idx] = pinputs[idx];
+	}
+}
+
+void
+di_read_button_activity(tBoardButtonMap *pactivity)
+{
+	uint32_t idx;
+
+	if(!pactivity)	{ return; }
+	for(idx = 0; idx < kBoardNumButtonWords; ++idx)
+	{
+		pactivity[idx] = keyactivity[idx];
+		keyactivity[idx] = 0;
+	}
+}
+
+#if (BOARD_BUTTON_EDGE_TIMES)
+/** A matrix scan sees edges only when it samples them, so it has no time better than the sample
+ *	time the debounce engine already uses; report none.
+ */
+void
+di_read_button_edge_times(tBoardButtonMap *pedges, tCwswClockTics *ptimes)
+{
+	uint32_t idx;
+
+	UNUSED(ptimes);
+	if(!pedges)	{ return; }
+	for(idx = 0; idx < kBoardNumButtonWords; ++idx)	{ pedges[idx] = 0; }
+}
+#endif
+
+#endif								/* } */
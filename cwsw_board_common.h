@@ -35,6 +35,92 @@ extern "C" {
 // ----	Constants -------------------------------------------------------------
 // ============================================================================
 
+#if !defined(BOARD_BUTTON_MAP_WORD_BITS)
+/** Width, in bits, of one word of a button bitmap; 32 or 64.
+ *	Bitmaps of any number of buttons are built from as many words as needed; wider words mean
+ *	fewer words to visit per tick on 64-bit desktop builds.
+ */
+#define BOARD_BUTTON_MAP_WORD_BITS	32
+#endif
+
+#if !defined(BOARD_BUTTON_EDGE_TIMES)
+/** When 1, the board captures the time of each button edge, and provides
+ *	di_read_button_edge_times(); the edge-timestamp debounce engine then uses those times in place
+ *	of the sample time.
+ */
+#define BOARD_BUTTON_EDGE_TIMES		0
+#endif
+
+#if !defined(BOARD_BUTTONS_MATRIX)
+/** When 1, the buttons are the keys of a row/column matrix, scanned by the common matrix driver
+ *	(see cwsw_bsp_matrix.h); the board then supplies the row and column hooks in place of its own
+ *	di_read_button_inputs() and di_read_button_activity().
+ */
+#define BOARD_BUTTONS_MATRIX		0
+#endif
+
+#if !defined(BOARD_LED_PWM)
+/** When 1, LEDs can be dimmed w/ Cwsw_Board__SetLedDuty(); the board's heartbeat then re-evaluates
+ *	the LED outputs every tick (see cwsw_bsp_ledpwm.h). When 0, an LED is only ever on or off.
+ */
+#define BOARD_LED_PWM				0
+#endif
+
+#if !defined(BOARD_LED_PWM_STEPS)
+/// Ticks per software-PWM period, i.e. the number of brightness steps above "off"; 2 .. 255.
+#define BOARD_LED_PWM_STEPS			16
+#endif
+
+#if !defined(BOARD_ANALOG)
+/** When 1, the board has analog inputs (rheostats), read through the common analog task (see
+ *	cwsw_bsp_analog.h). The board then defines `kBoardNumAnalogs` and implements di_read_analog_block().
+ */
+#define BOARD_ANALOG				0
+#endif
+
+#if !defined(BOARD_ANALOG_BITS)
+/// Resolution, in bits, of the board's analog samples; 8 .. 16.
+#define BOARD_ANALOG_BITS			12
+#endif
+
+#if !defined(BOARD_DISPLAY)
+/** When 1, the board has a text display, written through a back buffer w/ Cwsw_Board__DisplayWrite()
+ *	(see cwsw_bsp_display.h); only the changed spans are pushed to the screen, once per frame.
+ */
+#define BOARD_DISPLAY				0
+#endif
+
+#if !defined(BOARD_DISPLAY_ROWS)
+/// Lines of text on the display; 1 .. 32.
+#define BOARD_DISPLAY_ROWS			4
+#endif
+
+#if !defined(BOARD_DISPLAY_COLS)
+/// Characters per line of the display; 1 .. 255.
+#define BOARD_DISPLAY_COLS			40
+#endif
+
+/** Storage class of the "selected instance" pointers of components that can host several
+ *	instances: each thread selects its own.
+ */
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+#define BOARD_THREAD_LOCAL			_Thread_local
+#elif defined(__GNUC__)
+#define BOARD_THREAD_LOCAL			__thread
+#else
+#define BOARD_THREAD_LOCAL
+#endif
+
+/// Number of bitmap words needed to hold `numbuttons` buttons.
+#define BOARD_BUTTON_MAP_WORDS(numbuttons)	\
+	(((numbuttons) + BOARD_BUTTON_MAP_WORD_BITS - 1) / BOARD_BUTTON_MAP_WORD_BITS)
+
+/** Number of bitmap words for this board's buttons.
+ *	Resolved where it is used, after the board header has defined #kBoardNumButtons.
+ */
+#define kBoardNumButtonWords	BOARD_BUTTON_MAP_WORDS(kBoardNumButtons)
+
+
 /** Error codes relevant to the BSP.
  */
 enum eErrorCodes_Board {
@@ -43,7 +129,7 @@ enum eErrorCodes_Board {
 	kErr_Bsp_BadParm,                   	//!< Bad parameter. Aligned w/ base Library error codes.
 	kErr_Bsp_InitFailed,					//!< Generic "failed" return code; specific to BSP.
 	kErr_Board_NoMem,						//!< Not enough memory to initialize UI framework. Specific to LabWindows/CVI.
-	kErr_Board_NoPanel						//!< UI Panel failed to load for any one of a number of reasons. Specific to LabWindows/CVI.
+	kErr_Board_NoPanel						//!< UI Panel failed to load for any one of a number of reasons (GTK: no display). Specific to the UI boards.
 };
 
 
@@ -51,6 +137,27 @@ enum eErrorCodes_Board {
 // ----	Type Definitions ------------------------------------------------------
 // ============================================================================
 
+/** One word of a button bitmap.
+ *	A bitmap of all buttons is an array of #kBoardNumButtonWords words; bit N of word W corresponds
+ *	to button ID `(W * BOARD_BUTTON_MAP_WORD_BITS) + N`. For inputs, a set bit means "pressed".
+ */
+#if (BOARD_BUTTON_MAP_WORD_BITS == 64)
+typedef uint64_t tBoardButtonMap;
+#else
+typedef uint32_t tBoardButtonMap;
+#endif
+
+/** Test, set, or clear the bit for button `idx` in bitmap `map` (an array of tBoardButtonMap).
+ *	@{
+ */
+#define BTNMAP_TEST(map, idx)	\
+	(((map)[(idx) / BOARD_BUTTON_MAP_WORD_BITS] >> ((idx) % BOARD_BUTTON_MAP_WORD_BITS)) & 1u)
+#define BTNMAP_SET(map, idx)	\
+	((map)[(idx) / BOARD_BUTTON_MAP_WORD_BITS] |= ((tBoardButtonMap)1 << ((idx) % BOARD_BUTTON_MAP_WORD_BITS)))
+#define BTNMAP_CLR(map, idx)	\
+	((map)[(idx) / BOARD_BUTTON_MAP_WORD_BITS] &= ~((tBoardButtonMap)1 << ((idx) % BOARD_BUTTON_MAP_WORD_BITS)))
+/** @} */
+
 // ============================================================================
 // ----	Public Variables ------------------------------------------------------
 // ============================================================================
@@ -93,6 +200,55 @@ extern uint16_t Cwsw_Board__Init(ptEvQ_QueueCtrlEx pEvQX);
 /** Target for Get(Cwsw_Board, Initialized) interface */
 extern bool 	Cwsw_Board__Get_Initialized(void);
 
+/** Sample every button input at once.
+ *	Called once per button-task tick; every button's SM sees the value sampled at the same
+ *	instant. On physical boards this is intended to be one port read (or one matrix scan), not one
+ *	read per button.
+ *
+ *	@param[out]	pinputs	Bitmap of #kBoardNumButtonWords words, filled w/ this tick's inputs.
+ */
+extern void di_read_button_inputs(tBoardButtonMap *pinputs);
+
+/** Fetch, and clear, the set of button inputs that changed since the last scan.
+ *	Bits are set by the board's UI callbacks or port-change hardware. The button task uses this to
+ *	wake buttons it has parked, so idle inputs cost nothing per tick.
+ *
+ *	@param[out]	pactivity	Bitmap of #kBoardNumButtonWords words, filled w/ the inputs that had
+ *							activity since the previous call.
+ */
+extern void di_read_button_activity(tBoardButtonMap *pactivity);
+
+#if (BOARD_BUTTON_EDGE_TIMES)
+/** Fetch, and clear, the buttons that had an edge since the last call, w/ the time of each one's
+ *	most recent edge.
+ *
+ *	@param[out]	pedges	Bitmap of #kBoardNumButtonWords words: buttons w/ an edge to report.
+ *	@param[out]	ptimes	Array of #kBoardNumButtons times; only the entries of buttons set in
+ *						`pedges` are written.
+ */
+extern void di_read_button_edge_times(tBoardButtonMap *pedges, tCwswClockTics *ptimes);
+#endif
+
+
+#if (BOARD_LED_PWM)
+/** Dim LED `led` (an #eBoardLeds ID): it is lit on `duty` of every #BOARD_LED_PWM_STEPS ticks while it is on.
+ *	#BOARD_LED_PWM_STEPS (or more) restores full brightness. The on/off image is unchanged;
+ *	dimming applies whenever the LED is switched on.
+ */
+extern void Cwsw_Board__SetLedDuty(uint32_t led, uint8_t duty);
+#endif
+
+#if (BOARD_DISPLAY)
+/** Write `text` to the display's back buffer, starting at line `row`, column `col` (both from 0).
+ *	The text is clipped at the end of the line; it does not wrap, and a '\n' is just another
+ *	character. One byte per cell: anything but printable ASCII shows as '?'. Rewriting what is
+ *	already there costs a compare per character, and nothing reaches the screen.
+ */
+extern void Cwsw_Board__DisplayWrite(uint32_t row, uint32_t col, const char *text);
+
+/** Blank the whole display. */
+extern void Cwsw_Board__DisplayClear(void);
+#endif
 
 // ==== /Discrete Functions ================================================= }
 
@@ -113,6 +269,26 @@ enum { Cwsw_Board = 2 };	/* Component ID for boards; all supported boards have t
 /** Target symbol for Set(Cwsw_Board, Resource, xxx) interface */
 #define Cwsw_Board__Set(resource, value)	Cwsw_Board__Set_ ## resource(value)
 
+/** Target for `Set(Cwsw_Board, LedMask, mask)`: write every LED at once, bit 0 for LED1, bit 1 for
+ *	LED2, etc.; bits past the board's last LED are ignored. The mask goes to the board's shadow
+ *	image, and only LEDs whose bit changed are pushed to the port or widget.
+ */
+extern void Cwsw_Board__Set_LedMask(uint32_t mask);
+
+/** Target for `Get(Cwsw_Board, LedImage)`: bitmapped LED state, as last written by the
+ *	application (before any dimming); same layout as `LedMask`.
+ */
+extern uint32_t Cwsw_Board__Get_LedImage(void);
+
+#if (BOARD_DISPLAY)
+struct sBoardDisplay;
+
+/** Target for `Get(Cwsw_Board, Display)`: the display's back buffer, as the application wrote
+ *	it; see tBoardDisplay. Lets a headless run check what would be on screen.
+ */
+extern struct sBoardDisplay const *Cwsw_Board__Get_Display(void);
+#endif
+
 // ==== /Targets for Get/Set APIs =========================================== }
 
 #ifdef	__cplusplus
@@ -0,0 +1,296 @@
+/** @file
+ *	@brief	Benchmark of the button pipeline (Btn_tsk_ButtonRead() and the debounce engine under it),
+ *	run headless on the "none" board.
+ *
+ *	Each input profile is turned into a replay script (see none/src/di_button_replay.c) and fed to
+ *	the button task one scan per tick, as fast as the CPU allows. Per profile, one line is printed:
+ *	engine, button count, profile, ticks, ns/tick, ns/button, events, events/s, and worst-case tick
+ *	time.
+ *
+ *	The button count and debounce engine are compile-time choices; sweep them by rebuilding, e.g.
+ *	`-DBOARD_NONE_NUM_BUTTONS=256 -DBTN_DEBOUNCE_ENGINE=BTN_ENGINE_VERTICAL`. A 16x16 keypad, scanned
+ *	by the matrix driver, is `-DBOARD_BUTTONS_MATRIX=1 -DBOARD_NONE_MATRIX_ROWS=16
+ *	-DBOARD_NONE_MATRIX_COLS=16`; its "keypad" profile types one key at a time.
+ *
+ *	The "rebound" profile presses for 4 samples, opens for 4, then holds. On the vertical engine
+ *	built w/ 4-sample debouncing (`-DBTN_CAL_SAMPLES=4`, or a `BTN_CAL(btn, 4, ...)` calibration
+ *	row), each of its cycles is two presses and two releases per button, twice the events of
+ *	"clean"; a count that stops short of that means a bounce straight after an accepted press was
+ *	held against the next run. (The SME's state changes, and the timestamp engine's quiet time,
+ *	absorb the 4-sample gap.)
+ *
+ *	The project supplies:
+ *	-	cbBENCH_TICK(): advance the CWSW clock by one tick, and empty the button queue.
+ *	-	BENCH_BUTTON_QUEUE: (optional) the queue the button task posts to. W/out one, every post is
+ *		refused; refused posts still count as events here.
+ *
+ *	\copyright
+ *	Copyright (c) 2026 agent. All rights reserved.
+ *
+ *	Created on: Oct 14, 2026
+ *	@author agent
+ */
+
+// ============================================================================
+// ----	Include Files ---------------------------------------------------------
+// ============================================================================
+
+// ----	System Headers --------------------------
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE	199309L		/* clock_gettime() */
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ----	Project Headers -------------------------
+#include "cwsw_lib.h"
+
+// ----	Module Headers --------------------------
+#include "cwsw_board.h"
+#include "cwsw_bsp_buttons.h"
+#include "cwsw_bsp_buttons_cfg.h"	/* evButton_Task; engine selection */
+
+
+// ============================================================================
+// ----	Constants -------------------------------------------------------------
+// ============================================================================
+
+#if !defined(cbBENCH_TICK)
+#error "cbBENCH_TICK() must advance the CWSW clock by one tick (and empty the button queue)"
+#endif
+
+#if !defined(BENCH_BUTTON_QUEUE)
+#define BENCH_BUTTON_QUEUE		NULL
+#endif
+
+#if !defined(BENCH_TICKS)
+/// Timed ticks per profile.
+#define BENCH_TICKS				20000
+#endif
+
+/// Untimed ticks run after each profile, so every button is back at rest before the next one.
+#define kBenchSettleTicks		200
+
+/** Input patterns, one bit per tick, least-significant bit first.
+ *	Same patterns the GTK board uses to simulate a bouncing contact.
+ *	@{
+ */
+#define noisypatterna			0xFF7F7EFBDDA03F01ULL
+#define noisypatternb			0x100101020844AULL
+#define cleanpatterna			0xFF9ULL
+#define cleanpatternb			(~cleanpatterna & 0xFFF)
+#define reboundpatterna			0xFF0FULL
+/** @} */
+
+/// Ticks a button is held (or left released) between its press and release patterns.
+#define kBenchHoldTicks			40
+
+#if (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_VERTICAL)
+#define kBenchEngineName		"vertical"
+#elif (BTN_DEBOUNCE_ENGINE == BTN_ENGINE_TIMESTAMP)
+#define kBenchEngineName		"timestamp"
+#else
+#define kBenchEngineName		"sme"
+#endif
+
+
+// ============================================================================
+// ----	Type Definitions ------------------------------------------------------
+// ============================================================================
+
+/// One input profile: what every button does, over and over, for the length of the run.
+typedef struct sBenchProfile {
+	char const	*name;
+	uint64_t	press;			//!< bits seen on the way down
+	uint8_t		pressbits;
+	uint64_t	release;		//!< bits seen on the way up
+	uint8_t		releasebits;
+	bool		onekey;			//!< one button at a time, each in turn, as keys are typed on a keypad
+} tBenchProfile;
+
+
+// ============================================================================
+// ----	Module-level Variables ------------------------------------------------
+// ============================================================================
+
+static const tBenchProfile profiles[] = {
+	{ "idle",	0,				0,	0,				0,	false	},
+	{ "clean",	cleanpatterna,	12,	cleanpatternb,	12,	false	},
+	{ "noisy",	noisypatterna,	64,	noisypatternb,	52,	false	},
+	{ "keypad",	noisypatterna,	64,	noisypatternb,	52,	true	},
+	{ "rebound",	reboundpatterna,	16,	cleanpatternb,	12,	false	},
+};
+
+
+// ============================================================================
+// ----	Private Functions -----------------------------------------------------
+// ============================================================================
+
+static uint64_t
+NowNs(void)
+{
+#if defined(__unix__) || defined(__APPLE__)
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#else
+	return (uint64_t)clock() * (1000000000ULL / CLOCKS_PER_SEC);
+#endif
+}
+
+/** Input level of one button at tick `t`.
+ *	A cycle is: press pattern, held, release pattern, left released. Buttons are staggered through
+ *	the cycle so they don't all change on the same tick; for a `onekey` profile, they take turns
+ *	instead, one whole cycle each.
+ */
+static bool
+BenchLevel(tBenchProfile const *pprof, uint32_t button, uint32_t t)
+{
+	uint32_t cycle = pprof->pressbits + kBenchHoldTicks + pprof->releasebits + kBenchHoldTicks;
+	uint32_t u;
+
+	if(!pprof->pressbits)	{ return false; }
+
+	if(pprof->onekey)
+	{
+		if(((t / cycle) % (kBoardNumButtons - 1)) != (button - 1))	{ return false; }
+		u = t % cycle;
+	}
+	else
+	{
+		u = (t + button * 7) % cycle;
+	}
+	if(u < pprof->pressbits)	{ return ((pprof->press >> u) & 1) != 0; }
+	u -= pprof->pressbits;
+	if(u < kBenchHoldTicks)		{ return true; }
+	u -= kBenchHoldTicks;
+	if(u < pprof->releasebits)	{ return ((pprof->release >> u) & 1) != 0; }
+	return false;
+}
+
+static void
+wr_le32(uint8_t *p, uint32_t v)
+{
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+}
+
+/** Build the replay script for one profile: a record for every level change, plus a release of
+ *	everything still pressed at the end.
+ *	@returns a malloc'd script, and its size in `psize`; NULL if out of memory.
+ */
+static uint8_t *
+BenchScript(tBenchProfile const *pprof, uint32_t ticks, size_t *psize)
+{
+	static bool level[kBoardNumButtons];
+	size_t cap = 8 + 8 * 1024, len = 8;
+	uint8_t *pscript = (uint8_t *)malloc(cap);
+	uint32_t tlast = 0, t, b;
+	bool lvl;
+
+	if(!pscript)	{ return NULL; }
+	memcpy(pscript, "CWBR\x01\x00", 6);
+	pscript[6] = (uint8_t)kBoardNumButtons;
+	pscript[7] = (uint8_t)(kBoardNumButtons >> 8);
+	memset(level, 0, sizeof(level));
+
+	for(t = 0; t <= ticks; ++t)
+	{
+		for(b = kBoardButtonNone + 1; b < kBoardNumButtons; ++b)
+		{
+			lvl = (t < ticks) ? BenchLevel(pprof, b, t) : false;
+			if(lvl == level[b])	{ continue; }
+			level[b] = lvl;
+
+			if(len + 8 > cap)
+			{
+				uint8_t *pgrow = (uint8_t *)realloc(pscript, cap * 2);
+				if(!pgrow)	{ free(pscript); return NULL; }
+				pscript = pgrow;
+				cap *= 2;
+			}
+			wr_le32(&pscript[len], t + 1 - tlast);	// tick t is read after the clock's (t+1)th advance
+			pscript[len + 4] = (uint8_t)b;
+			pscript[len + 5] = (uint8_t)(b >> 8);
+			pscript[len + 6] = lvl ? 1 : 0;
+			pscript[len + 7] = 0;
+			len += 8;
+			tlast = t + 1;
+		}
+	}
+	*psize = len;
+	return pscript;
+}
+
+static void
+BenchRun(tBenchProfile const *pprof, uint32_t ticks)
+{
+	tEvQ_Event ev = { evButton_Task, 0 };
+	uint64_t t0, dt, total = 0, worst = 0;
+	uint32_t events, idx;
+	size_t size = 0;
+	uint8_t *pscript = BenchScript(pprof, ticks, &size);
+
+	if(!pscript || (bd_none__ReplayOpenMem(pscript, size) != kErr_Bsp_NoError))
+	{
+		printf("%s: could not build script\n", pprof->name);
+		free(pscript);
+		return;
+	}
+
+	events = Get(Cwsw_Board, BtnEventsPosted) + Get(Cwsw_Board, BtnEventsDropped);
+	for(idx = 0; idx < ticks; ++idx)
+	{
+		cbBENCH_TICK();
+		t0 = NowNs();
+		Btn_tsk_ButtonRead(ev, 0);
+		dt = NowNs() - t0;
+		total += dt;
+		if(dt > worst)	{ worst = dt; }
+	}
+	events = Get(Cwsw_Board, BtnEventsPosted) + Get(Cwsw_Board, BtnEventsDropped) - events;
+
+	for(idx = 0; idx < kBenchSettleTicks; ++idx)
+	{
+		cbBENCH_TICK();
+		Btn_tsk_ButtonRead(ev, 0);
+	}
+	bd_none__ReplayClose();
+	free(pscript);
+
+	printf("%-9s %5u %-7s %7u %10.1f %9.2f %8u %12.0f %9llu\n",
+			kBenchEngineName, (unsigned)kBoardNumButtons, pprof->name, (unsigned)ticks,
+			(double)total / ticks,
+			(double)total / ticks / kBoardNumButtons,
+			(unsigned)events,
+			total ? (double)events * 1e9 / (double)total : 0.0,
+			(unsigned long long)worst);
+}
+
+
+// ============================================================================
+// ----	Public Functions ------------------------------------------------------
+// ============================================================================
+
+int
+main(int argc, char *argv[])
+{
+	uint32_t ticks = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : BENCH_TICKS;
+	uint32_t idx;
+
+	if(!ticks)	{ ticks = BENCH_TICKS; }
+
+	Btn_SetQueue(evButton_Task, BENCH_BUTTON_QUEUE);
+
+	printf("%-9s %5s %-7s %7s %10s %9s %8s %12s %9s\n",
+			"engine", "btns", "input", "ticks", "ns/tick", "ns/btn", "events", "events/s", "worst-ns");
+	for(idx = 0; idx < TABLE_SIZE(profiles); ++idx)
+	{
+		BenchRun(&profiles[idx], ticks);
+	}
+	return 0;
+}
@@ -38,6 +38,8 @@
 
 // ----	Module Headers --------------------------
 #include "../cwsw_board_common.h"
+#include "cwsw_bsp_ledpwm.h"		/* tBoardLedPwm */
+#include "cwsw_bsp_display.h"		/* tBoardDisplay */
 #if (XPRJ_Debug_CVI)
 #include "cwsw_dio_uir.h"		/* CVI's control defines (PANEL_LED1, PANEL_BTN_1, et. al. */
 #endif
@@ -73,6 +75,27 @@ enum eBrdUsbVbusSwitchState
 };
 
 
+#if (BOARD_BUTTONS_MATRIX)
+#if !defined(BOARD_NONE_MATRIX_ROWS)
+/// Row lines of the simulated keypad, when #BOARD_BUTTONS_MATRIX is set.
+#define BOARD_NONE_MATRIX_ROWS		4
+#endif
+#if !defined(BOARD_NONE_MATRIX_COLS)
+/// Column lines of the simulated keypad; no more than #BOARD_BUTTON_MAP_WORD_BITS.
+#define BOARD_NONE_MATRIX_COLS		4
+#endif
+
+/** Shape of the simulated keypad (see cwsw_bsp_matrix.h). Its keys are the replayed buttons, from
+ *	kBoardButton0 on; the matrix driver reads them one row at a time.
+ */
+enum eBoardMatrix
+{
+	kBoardMatrixRows		= BOARD_NONE_MATRIX_ROWS,
+	kBoardMatrixCols		= BOARD_NONE_MATRIX_COLS,
+	kBoardMatrixFirstButton	= 1		/* kBoardButton0 */
+};
+#endif
+
 /** Button IDs for this board. */
 enum eBoardButtons
 {
@@ -85,7 +108,23 @@ enum eBoardButtons
 	kBoardButton5,
 	kBoardButton6,
 	kBoardButton7,
+#if defined(BOARD_NONE_NUM_BUTTONS)
+	kBoardNumButtons = BOARD_NONE_NUM_BUTTONS	//!< override, e.g. to benchmark larger button counts; at least 9
+#elif (BOARD_BUTTONS_MATRIX)
+	kBoardNumButtons = 1 + (BOARD_NONE_MATRIX_ROWS * BOARD_NONE_MATRIX_COLS)	//!< one per key; at least 8 keys
+#else
 	kBoardNumButtons
+#endif
+};
+
+/** Analog inputs (rheostats) of this board, when #BOARD_ANALOG is set; their levels are set w/
+ *	bd_none__SetAnalog().
+ */
+enum eBoardAnalogs
+{
+	kBoardAnalog0,
+	kBoardAnalog1,
+	kBoardNumAnalogs
 };
 
 /** tBoardLed.
@@ -128,17 +167,137 @@ typedef enum eBrdSwitch				tBrdUserSwitch;
 
 typedef enum eBoardLeds				tBoardLed;
 
+struct sBtnInstance;
+
+/** One simulated board: its replayed inputs, its LEDs, and its instance of the button task.
+ *	Declared here so a host can allocate as many boards as it needs (see Cwsw_Board__InitInstance());
+ *	the members belong to this board's implementation.
+ */
+typedef struct sBoardInstance {
+	bool				initialized;
+	uint32_t			ledimage;		//!< bitmapped LED image, as last written by the application
+#if (BOARD_LED_PWM)
+	tBoardLedPwm		ledpwm;			//!< dimming of each LED
+#endif
+	struct sBtnInstance	*pbtn;			//!< this board's button task; NULL for the default instance
+
+	const uint8_t		*preplay;		//!< start of the mapped (or loaded) replay file
+	size_t				replaysize;
+	size_t				replaypos;		//!< offset of the next record not yet applied
+	uint8_t				replayowner;	//!< who releases `preplay`
+	tCwswClockTics		tmReplayStart;	//!< clock at ReplayOpen(); record times are relative to this
+	tCwswClockTics		tmNextRecord;	//!< replay time of the record at `replaypos`
+
+	tBoardButtonMap		buttonstatus[kBoardNumButtonWords];		//!< bitmapped image of current button state
+	tBoardButtonMap		buttonactivity[kBoardNumButtonWords];	//!< inputs that changed since the last scan
+#if (BOARD_BUTTONS_MATRIX)
+	uint32_t			matrixrow;		//!< keypad row the matrix driver is strobing
+#endif
+#if (BOARD_BUTTON_EDGE_TIMES)
+	tBoardButtonMap		buttonedgemask[kBoardNumButtonWords];	//!< inputs w/ an edge time not yet read
+	tCwswClockTics		buttonedgetime[kBoardNumButtons];		//!< replay time of each input's last edge
+#endif
+#if (BOARD_ANALOG)
+	uint16_t			analoginputs[kBoardNumAnalogs];			//!< level each analog input reads
+#endif
+#if (BOARD_DISPLAY)
+	tBoardDisplay		display;		//!< the display; w/ no screen to push to, only the back buffer
+#endif
+} tBoardInstance;
+
+/// Totals from one bd_none__FleetRun().
+typedef struct sBoardFleetStats {
+	uint32_t			ticks;			//!< lock-step ticks run
+	uint32_t			threads;		//!< workers used, counting the calling thread
+	uint64_t			scans;			//!< button-task runs, summed over every board
+	uint64_t			steals;			//!< chunks of boards a worker took from another's share
+} tBoardFleetStats;
+
 
 // ============================================================================
 // ----	Public Variables ------------------------------------------------------
 // ============================================================================
 
+/** Board instance the calling thread is working on; change it w/ Cwsw_Board__SelectInstance().
+ *	Everything in this API, including the DI reads under the button task, acts on this instance.
+ */
+extern BOARD_THREAD_LOCAL tBoardInstance *pBoardInstance;
+
 // ============================================================================
 // ----	Public API ------------------------------------------------------------
 // ============================================================================
 
 // --- discrete functions --------------------------------------------------- {
 
+/** Set up one more board instance, w/ its own button task whose notifications go to `pEvQX`.
+ *	What Cwsw_Board__Init() is to the default instance; the button task's instance comes from
+ *	Btn_NewInstance(), so `BTN_MAX_INSTANCES` bounds how many boards can be set up.
+ *	@returns #kErr_Bsp_BadParm for a NULL `pbd`; #kErr_Bsp_InitFailed once the button instances
+ *	are used up.
+ */
+extern uint16_t Cwsw_Board__InitInstance(tBoardInstance *pbd, ptEvQ_QueueCtrlEx pEvQX);
+
+/** Select the board instance (and w/ it, its button task) that this thread works on.
+ *	NULL selects the default instance.
+ *	@returns the instance selected until now, to be restored by the caller.
+ */
+extern tBoardInstance *Cwsw_Board__SelectInstance(tBoardInstance *pbd);
+
+/** Run one tick of the button task of board `pbd`, as Btn_tsk_ButtonRead() does for the selected
+ *	board. The thread's selection is left as it was.
+ */
+extern void bd_none__tsk_ButtonRead(tBoardInstance *pbd, tEvQ_Event ev, uint32_t extra);
+
+/** Step `count` boards (each set up by Cwsw_Board__InitInstance()) for `ticks` ticks of lock-step
+ *	simulated time, spread over `threads` workers (0: one per online CPU), the caller among them.
+ *	Before each tick, the caller runs cbFLEET_TICK(), which must advance the CWSW clock; then every
+ *	board's scan alarm is serviced once, on whichever worker gets to it, running its button task if
+ *	due. Workers that run out of boards steal from the others.
+ *
+ *	A board's queues are posted to from whatever worker steps it, so no two boards may share one
+ *	unless it is thread-safe. Only one fleet runs at a time; the thread's selection is left as it was.
+ *	@returns #kErr_Bsp_BadParm for no boards.
+ */
+extern uint16_t bd_none__FleetRun(tBoardInstance *pboards, uint32_t count, uint32_t threads,
+		uint32_t ticks, tBoardFleetStats *pstats);
+
+/** Open a button script (see di_button_replay.c for the layout) and start replaying it from the
+ *	current clock. Any replay already open is closed first.
+ *	@returns #kErr_Bsp_BadParm for a missing path or a malformed file; #kErr_Bsp_InitFailed if the
+ *	file can't be opened.
+ */
+extern uint16_t bd_none__ReplayOpen(const char *path);
+
+/** As bd_none__ReplayOpen(), but from a script already in memory (e.g., one generated by a test
+ *	or benchmark). The buffer must stay valid until the replay is closed; it is never freed here.
+ *	@returns #kErr_Bsp_BadParm for a missing or malformed script; whatever replay was open stays
+ *	open, untouched.
+ */
+extern uint16_t bd_none__ReplayOpenMem(const void *pscript, size_t size);
+
+/** Stop replaying; every button reads "released" again. */
+extern void bd_none__ReplayClose(void);
+
+/** True when the next scripted edge has come due, but not yet been read by the button task.
+ *	The replay's stand-in for an input interrupt: a board whose scan alarm is parked (see
+ *	#BTN_SCAN_IDLE_PERIOD) uses this to know when to call Btn_Wake().
+ */
+extern bool bd_none__ReplayDue(void);
+
+#if (BOARD_ANALOG)
+/** Set the level analog input `channel` reads from now on, in ADC counts (#BOARD_ANALOG_BITS wide).
+ *	Every sample of the block reads the same level; a test scripts noise or ramps by calling this
+ *	between scans.
+ */
+extern void bd_none__SetAnalog(uint32_t channel, uint16_t value);
+#endif
+
+/** Run `ticks` heartbeats back to back, w/out waiting on the wall clock.
+ *	Each heartbeat is one call to cbHEARTBEAT_ACTION(); only built when the project defines it.
+ *	@returns the number of heartbeats run.
+ */
+extern uint32_t bd_none__Run(uint32_t ticks);
+
 // --- /discrete functions -------------------------------------------------- }
 
 // --- targets for Get/Set APIS --------------------------------------------- {
@@ -165,6 +324,16 @@ extern void Cwsw_Board__Set_kBoardLed3(bool value);
 extern void Cwsw_Board__Set_kBoardLed4(bool value);
 /**	@} */
 
+/** Target for `Get(Cwsw_Board, LedOutput)`: what the LED pins show on this tick; the LED image,
+ *	w/ dimmed LEDs lit only on their share of the ticks. Same as `LedImage` w/out #BOARD_LED_PWM.
+ */
+extern uint32_t Cwsw_Board__Get_LedOutput(void);
+
+/** Target for `Get(Cwsw_Board, ReplayDone)`: true once every scripted edge has been applied, or
+ *	when no replay is open.
+ */
+extern bool Cwsw_Board__Get_ReplayDone(void);
+
 // --- /targets for Get/Set APIS -------------------------------------------- }
 
 
@@ -0,0 +1,329 @@
+/** @file
+ *	@brief	Headless multi-board runner for the "none" board: many board instances, stepped in
+ *	lock-step simulated time on a pool of worker threads.
+ *
+ *	Each tick is one epoch. Between epochs, the calling thread runs cbFLEET_TICK() to advance the
+ *	(process-wide) CWSW clock; during an epoch, every board is visited exactly once, by one worker,
+ *	and its scan alarm serviced: an expired alarm is reloaded and the board's button task run, as
+ *	the project's alarm service would do for a single board. Nothing touches the clock during an
+ *	epoch, so every board sees the same time, whichever thread steps it.
+ *
+ *	The boards are cut into chunks of #FLEET_CHUNK. Each worker starts an epoch w/ an equal share of
+ *	chunks, held as a [lo, hi) range in one atomic word; it takes chunks from the bottom of its own
+ *	range, and once that is empty, steals the upper half of another worker's. A worker whose boards
+ *	are all at rest (alarm not yet due) runs dry early and helps the ones w/ boards mid-debounce.
+ *
+ *	W/out POSIX threads or C11 atomics, the caller steps every board itself.
+ *
+ *	\copyright
+ *	Copyright (c) 2026 agent. All rights reserved.
+ *
+ *	Created on: Oct 14, 2026
+ *	@author agent
+ */
+
+// ============================================================================
+// ----	Include Files ---------------------------------------------------------
+// ============================================================================
+
+// ----	System Headers --------------------------
+#if (defined(__unix__) || defined(__APPLE__)) && \
+	defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#define FLEET_HAS_THREADS	1
+#else
+#define FLEET_HAS_THREADS	0
+#endif
+
+// ----	Project Headers -------------------------
+#include "cwsw_lib.h"
+
+// ----	Module Headers --------------------------
+#include "cwsw_board.h"
+#include "cwsw_bsp_buttons.h"
+#include "cwsw_bsp_buttons_cfg.h"	/* evButton_Task */
+
+
+// ============================================================================
+// ----	Constants -------------------------------------------------------------
+// ============================================================================
+
+#if !defined(cbFLEET_TICK)
+/** Work done between epochs, on the calling thread; the project defines this in projcfg.h.
+ *	It must advance the CWSW clock by one tick, and may drain the boards' queues.
+ */
+#define cbFLEET_TICK()
+#endif
+
+#if !defined(FLEET_CHUNK)
+/// Boards per unit of work: the grain at which workers share (and steal) boards.
+#define FLEET_CHUNK			16
+#endif
+
+#if !defined(FLEET_MAX_THREADS)
+/// Upper bound on worker threads, counting the caller.
+#define FLEET_MAX_THREADS	64
+#endif
+
+/** Range of chunks packed in one word, so that taking from either end is a single CAS.
+ *	@{
+ */
+#define FleetRange(lo, hi)	(((uint64_t)(hi) << 32) | (uint32_t)(lo))
+#define FleetLo(range)		((uint32_t)(range))
+#define FleetHi(range)		((uint32_t)((range) >> 32))
+/** @} */
+
+
+// ============================================================================
+// ----	Type Definitions ------------------------------------------------------
+// ============================================================================
+
+#if (FLEET_HAS_THREADS)
+/// One worker's share of the current epoch; padded so that no two workers' ranges share a line.
+typedef struct sFleetWorker {
+	_Atomic uint64_t	range;		//!< chunks [lo, hi) not yet taken
+	uint64_t			scans;		//!< button-task runs by this worker
+	uint64_t			steals;		//!< chunks taken from another worker
+	char				pad[64 - 3 * sizeof(uint64_t)];
+} tFleetWorker;
+
+typedef struct sFleet {
+	tBoardInstance		*pboards;
+	uint32_t			count;
+	uint32_t			chunks;
+	uint32_t			threads;
+	_Atomic uint32_t	epoch;		//!< bumped by the caller to start the next tick
+	_Atomic uint32_t	pending;	//!< workers still busy w/ the current epoch
+	_Atomic bool		stop;
+	tFleetWorker		workers[FLEET_MAX_THREADS];
+} tFleet;
+
+typedef struct sFleetThread {
+	tFleet				*pfleet;
+	uint32_t			id;
+} tFleetThread;
+#endif
+
+
+// ============================================================================
+// ----	Global Variables ------------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Module-level Variables ------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Private Functions -----------------------------------------------------
+// ============================================================================
+
+/** Service one board's scan alarm for the current tick.
+ *	A parked alarm (scan period 0) is woken by a scripted edge coming due, just as a UI board wakes
+ *	it from its input callback.
+ *	@returns 1 if the button task ran, 0 if the board had nothing due.
+ */
+static uint32_t
+FleetStep(tBoardInstance *pbd)
+{
+	tEvQ_Event ev = { evButton_Task, 0 };
+	tCwswSwAlarm *palarm;
+
+	(void)Cwsw_Board__SelectInstance(pbd);
+	palarm = Get(Cwsw_Board, BtnAlarm);
+	if((palarm->tmrstate == kTmrState_Disabled) && bd_none__ReplayDue())	{ Btn_Wake(); }
+	if(palarm->tmrstate == kTmrState_Disabled)	{ return 0; }
+	if(Cwsw_GetTimeLeft(palarm->tm) > 0)		{ return 0; }
+
+	Set(Cwsw_Clock, palarm->tm, palarm->reloadtm);
+	Btn_tsk_ButtonRead(ev, 0);
+	return 1;
+}
+
+#if (FLEET_HAS_THREADS)
+/// Step every board of chunk `chunk`.
+static uint32_t
+FleetStepChunk(tFleet *pfleet, uint32_t chunk)
+{
+	uint32_t idx = chunk * FLEET_CHUNK;
+	uint32_t end = (idx + FLEET_CHUNK < pfleet->count) ? idx + FLEET_CHUNK : pfleet->count;
+	uint32_t scans = 0;
+
+	for( ; idx < end; ++idx)	{ scans += FleetStep(&pfleet->pboards[idx]); }
+	return scans;
+}
+
+/** Take the lowest chunk from worker `pw`'s own range.
+ *	@returns false once the range is empty.
+ */
+static bool
+FleetTakeOwn(tFleetWorker *pw, uint32_t *pchunk)
+{
+	uint64_t range = atomic_load(&pw->range);
+
+	while(FleetLo(range) < FleetHi(range))
+	{
+		if(atomic_compare_exchange_weak(&pw->range, &range, FleetRange(FleetLo(range) + 1, FleetHi(range))))
+		{
+			*pchunk = FleetLo(range);
+			return true;
+		}
+	}
+	return false;
+}
+
+/** Steal the upper half of some other worker's range, and make it worker `id`'s own.
+ *	Victims are tried in turn, starting w/ the next worker up, so that idle workers spread out.
+ *	@returns false once no worker has anything left to take.
+ */
+static bool
+FleetSteal(tFleet *pfleet, uint32_t id)
+{
+	uint32_t n, victim, lo, hi, take;
+	uint64_t range;
+
+	for(n = 1; n < pfleet->threads; ++n)
+	{
+		victim = (id + n) % pfleet->threads;
+		range = atomic_load(&pfleet->workers[victim].range);
+		while((lo = FleetLo(range)) < (hi = FleetHi(range)))
+		{
+			take = (hi - lo + 1) / 2;
+			if(atomic_compare_exchange_weak(&pfleet->workers[victim].range, &range, FleetRange(lo, hi - take)))
+			{
+				pfleet->workers[id].steals += take;
+				atomic_store(&pfleet->workers[id].range, FleetRange(hi - take, hi));
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/// Worker `id`'s part of one epoch: its own chunks, then whatever it can steal.
+static void
+FleetEpoch(tFleet *pfleet, uint32_t id)
+{
+	tFleetWorker *pw = &pfleet->workers[id];
+	uint32_t chunk;
+
+	do {
+		while(FleetTakeOwn(pw, &chunk))	{ pw->scans += FleetStepChunk(pfleet, chunk); }
+	} while(FleetSteal(pfleet, id));
+	(void)atomic_fetch_sub(&pfleet->pending, 1);
+}
+
+static void *
+FleetThread(void *parg)
+{
+	tFleetThread *pt = (tFleetThread *)parg;
+	tFleet *pfleet = pt->pfleet;
+	uint32_t seen = 0;
+
+	for(;;)
+	{
+		while(atomic_load(&pfleet->epoch) == seen)	{ (void)sched_yield(); }
+		if(atomic_load(&pfleet->stop))				{ break; }
+		++seen;
+		FleetEpoch(pfleet, pt->id);
+	}
+	return NULL;
+}
+#endif
+
+
+// ============================================================================
+// ----	Public Functions ------------------------------------------------------
+// ============================================================================
+
+uint16_t
+bd_none__FleetRun(tBoardInstance *pboards, uint32_t count, uint32_t threads, uint32_t ticks,
+		tBoardFleetStats *pstats)
+{
+	tBoardInstance *pprev;
+	uint64_t scans = 0, steals = 0;
+	uint32_t tick, idx;
+
+	if(!pboards || !count)	{ return kErr_Bsp_BadParm; }
+	pprev = Cwsw_Board__SelectInstance(NULL);
+
+#if (FLEET_HAS_THREADS)
+	{
+		static tFleet fleet;
+		tFleetThread args[FLEET_MAX_THREADS];
+		pthread_t tids[FLEET_MAX_THREADS];
+		uint32_t started;
+
+		if(!threads)
+		{
+			long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+			threads = (ncpu > 0) ? (uint32_t)ncpu : 1;
+		}
+		fleet.pboards	= pboards;
+		fleet.count		= count;
+		fleet.chunks	= (count + FLEET_CHUNK - 1) / FLEET_CHUNK;
+		if(threads > FLEET_MAX_THREADS)	{ threads = FLEET_MAX_THREADS; }
+		if(threads > fleet.chunks)		{ threads = fleet.chunks; }
+		atomic_store(&fleet.epoch, 0);
+		atomic_store(&fleet.stop, false);
+		for(idx = 0; idx < threads; ++idx)
+		{
+			fleet.workers[idx].scans	= 0;
+			fleet.workers[idx].steals	= 0;
+			atomic_store(&fleet.workers[idx].range, FleetRange(0, 0));
+		}
+
+		// the caller is worker 0; a thread that can't be started just leaves its share to the rest
+		for(started = 1; started < threads; ++started)
+		{
+			args[started].pfleet	= &fleet;
+			args[started].id		= started;
+			if(pthread_create(&tids[started], NULL, FleetThread, &args[started]))	{ break; }
+		}
+		threads = fleet.threads = started;
+
+		for(tick = 0; tick < ticks; ++tick)
+		{
+			cbFLEET_TICK();
+			for(idx = 0; idx < threads; ++idx)
+			{
+				atomic_store(&fleet.workers[idx].range,
+						FleetRange(fleet.chunks * idx / threads, fleet.chunks * (idx + 1) / threads));
+			}
+			atomic_store(&fleet.pending, threads);
+			(void)atomic_fetch_add(&fleet.epoch, 1);
+
+			FleetEpoch(&fleet, 0);
+			while(atomic_load(&fleet.pending))	{ (void)sched_yield(); }
+		}
+
+		atomic_store(&fleet.stop, true);
+		(void)atomic_fetch_add(&fleet.epoch, 1);
+		for(idx = 1; idx < threads; ++idx)	{ (void)pthread_join(tids[idx], NULL); }
+		for(idx = 0; idx < threads; ++idx)
+		{
+			scans	+= fleet.workers[idx].scans;
+			steals	+= fleet.workers[idx].steals;
+		}
+	}
+#else
+	threads = 1;
+	for(tick = 0; tick < ticks; ++tick)
+	{
+		cbFLEET_TICK();
+		for(idx = 0; idx < count; ++idx)	{ scans += FleetStep(&pboards[idx]); }
+	}
+#endif
+
+	(void)Cwsw_Board__SelectInstance(pprev);
+	if(pstats)
+	{
+		pstats->ticks	= ticks;
+		pstats->threads	= threads;
+		pstats->scans	= scans;
+		pstats->steals	= steals;
+	}
+	return kErr_Bsp_NoError;
+}
@@ -14,6 +14,7 @@
 // ============================================================================
 
 // ----	System Headers --------------------------
+#include <string.h>
 
 // ----	Project Headers -------------------------
 #include "cwsw_lib.h"
@@ -23,6 +24,8 @@
 
 // ----	Module Headers --------------------------
 #include "cwsw_board.h"
+#include "cwsw_bsp_buttons.h"		/* Btn_NewInstance() */
+#include "cwsw_bsp_analog.h"			/* Ain_SetEventQueue() */
 
 
 // ============================================================================
@@ -37,13 +40,14 @@
 // ----	Global Variables ------------------------------------------------------
 // ============================================================================
 
+/// the default instance: the one Cwsw_Board__Init() sets up, and the one every thread starts out on.
+static tBoardInstance bdDefault = {0};
+BOARD_THREAD_LOCAL tBoardInstance *pBoardInstance = &bdDefault;
+
 // ============================================================================
 // ----	Module-level Variables ------------------------------------------------
 // ============================================================================
 
-static bool initialized = false;
-
-
 // ============================================================================
 // ----	Private Prototypes ----------------------------------------------------
 // ============================================================================
@@ -60,8 +64,10 @@ static bool initialized = false;
  *	@returns error code, where 0 (#kErr_Lib_NoError) means no problem.
  */
 uint16_t
-Cwsw_Board__Init(void)
+Cwsw_Board__Init(ptEvQ_QueueCtrlEx pEvQX)
 {
+	tBoardInstance *pprev;
+
 	if(!Get(Cwsw_Arch, Initialized))
 	{
 		return 1;
@@ -82,36 +88,165 @@ Cwsw_Board__Init(void)
 	#pragma GCC diagnostic pop
 	#endif
 
+	// debounced button notifications go to the queue the board was given
+	pprev = Cwsw_Board__SelectInstance(NULL);
+	Btn_SetEventQueue(pEvQX);
+	(void)Cwsw_Board__SelectInstance(pprev);
+#if (BOARD_ANALOG)
+	Ain_SetEventQueue(pEvQX);
+#endif
+#if (BOARD_DISPLAY)
+	di_display_init(&bdDefault.display);
+#endif
+
+	bdDefault.initialized = true;
 	return 0;
 }
 
+uint16_t
+Cwsw_Board__InitInstance(tBoardInstance *pbd, ptEvQ_QueueCtrlEx pEvQX)
+{
+	tBoardInstance *pprev;
+
+	if(!pbd)	{ return kErr_Bsp_BadParm; }
+	memset(pbd, 0, sizeof(*pbd));
+	pbd->pbtn = Btn_NewInstance();
+	if(!pbd->pbtn)	{ return kErr_Bsp_InitFailed; }
+
+	pprev = Cwsw_Board__SelectInstance(pbd);
+	Btn_SetEventQueue(pEvQX);
+	(void)Cwsw_Board__SelectInstance(pprev);
+#if (BOARD_DISPLAY)
+	di_display_init(&pbd->display);
+#endif
+
+	pbd->initialized = true;
+	return kErr_Bsp_NoError;
+}
+
+tBoardInstance *
+Cwsw_Board__SelectInstance(tBoardInstance *pbd)
+{
+	tBoardInstance *pprev = pBoardInstance;
+
+	pBoardInstance = pbd ? pbd : &bdDefault;
+	(void)Btn_SelectInstance(pBoardInstance->pbtn);
+	return pprev;
+}
+
+void
+bd_none__tsk_ButtonRead(tBoardInstance *pbd, tEvQ_Event ev, uint32_t extra)
+{
+	tBoardInstance *pprev = Cwsw_Board__SelectInstance(pbd);
+	Btn_tsk_ButtonRead(ev, extra);
+	(void)Cwsw_Board__SelectInstance(pprev);
+}
+
 bool
 Cwsw_Board__Get_Initialized(void)
 {
-	return initialized;
+	return pBoardInstance->initialized;
+}
+
+
+uint32_t
+Cwsw_Board__Get_LedImage(void)
+{
+	return pBoardInstance->ledimage;
+}
+
+uint32_t
+Cwsw_Board__Get_LedOutput(void)
+{
+#if (BOARD_LED_PWM)
+	return di_led_pwm_apply(&pBoardInstance->ledpwm, pBoardInstance->ledimage, Get(Cwsw_Clock, Now));
+#else
+	return pBoardInstance->ledimage;
+#endif
+}
+
+#if (BOARD_LED_PWM)
+void
+Cwsw_Board__SetLedDuty(uint32_t led, uint8_t duty)
+{
+	if(led < kBoardNumLeds)	{ di_led_pwm_set(&pBoardInstance->ledpwm, led, duty); }
+}
+#endif
+
+void
+Cwsw_Board__Set_LedMask(uint32_t mask)
+{
+	pBoardInstance->ledimage = mask & ((1UL << kBoardNumLeds) - 1);
 }
 
 
 void
 Cwsw_Board__Set_kBoardLed1(bool value)
 {
-	UNUSED(value);
+	if(value)	{ BIT_SET(pBoardInstance->ledimage, 0); }
+	else		{ BIT_CLR(pBoardInstance->ledimage, 0); }
 }
 
 void
 Cwsw_Board__Set_kBoardLed2(bool value)
 {
-	UNUSED(value);
+	if(value)	{ BIT_SET(pBoardInstance->ledimage, 1); }
+	else		{ BIT_CLR(pBoardInstance->ledimage, 1); }
 }
 
 void
 Cwsw_Board__Set_kBoardLed3(bool value)
 {
-	UNUSED(value);
+	if(value)	{ BIT_SET(pBoardInstance->ledimage, 2); }
+	else		{ BIT_CLR(pBoardInstance->ledimage, 2); }
 }
 
 void
 Cwsw_Board__Set_kBoardLed4(bool value)
 {
-	UNUSED(value);
+	if(value)	{ BIT_SET(pBoardInstance->ledimage, 3); }
+	else		{ BIT_CLR(pBoardInstance->ledimage, 3); }
+}
+
+#if (BOARD_DISPLAY)
+void
+Cwsw_Board__DisplayWrite(uint32_t row, uint32_t col, const char *text)
+{
+	(void)di_display_write(&pBoardInstance->display, row, col, text, BOARD_DISPLAY_COLS);
+}
+
+void
+Cwsw_Board__DisplayClear(void)
+{
+	(void)di_display_clear(&pBoardInstance->display);
+}
+
+struct sBoardDisplay const *
+Cwsw_Board__Get_Display(void)
+{
+	return &pBoardInstance->display;
+}
+#endif
+
+#if (BOARD_ANALOG)
+void
+bd_none__SetAnalog(uint32_t channel, uint16_t value)
+{
+	if(channel < kBoardNumAnalogs)	{ pBoardInstance->analoginputs[channel] = value; }
+}
+
+/** Sample every analog input; with nothing set, every channel reads 0.
+ *	The simulated inputs hold still for the whole block.
+ */
+void
+di_read_analog_block(uint16_t *psamples, uint32_t count)
+{
+	uint32_t ch, idx;
+
+	if(!psamples)	{ return; }
+	for(ch = 0; ch < kBoardNumAnalogs; ++ch)
+	{
+		for(idx = 0; idx < count; ++idx)	{ *psamples++ = pBoardInstance->analoginputs[ch]; }
+	}
 }
+#endif
@@ -0,0 +1,395 @@
+/** @file
+ *	@brief	Headless DI for the "none" board: button inputs replayed from a recorded or scripted file.
+ *
+ *	The file is memory-mapped (or, where mmap isn't available, read in whole) and walked in step w/
+ *	the CWSW clock. Nothing here waits on wall-clock time; bd_none__Run() drives the heartbeat as
+ *	fast as the CPU allows, so a 30 s stuck-button timeout replays in however long 30000 ticks take.
+ *
+ *	File layout (all multi-byte fields little-endian):
+ *	-	header, 8 bytes: magic "CWBR", version (1), reserved (0), button count (uint16).
+ *	-	then any number of 8-byte edge records:
+ *		-	delta (uint32): ticks since the previous record (since the start of the replay, for the 1st).
+ *		-	button (uint16): button ID.
+ *		-	level (uint8): 1 for pressed, 0 for released.
+ *		-	kind (uint8): 0 for an input edge. Traces written by Btn_TraceFlush() also carry state
+ *			changes and events (see eBtnTraceKind); those only advance time here.
+ *
+ *	Only changes are stored, so a button held (or bouncing) for any length of time costs one record
+ *	per edge, never one per tick. Bounce is scripted as extra edges a tick or two apart.
+ *
+ *	\copyright
+ *	Copyright (c) 2026 agent. All rights reserved.
+ *
+ *	Created on: Oct 14, 2026
+ *	@author agent
+ */
+
+// ============================================================================
+// ----	Include Files ---------------------------------------------------------
+// ============================================================================
+
+// ----	System Headers --------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define REPLAY_HAS_MMAP		1
+#else
+#define REPLAY_HAS_MMAP		0
+#endif
+
+// ----	Project Headers -------------------------
+#include "cwsw_lib.h"
+
+// ----	Module Headers --------------------------
+#include "cwsw_board.h"
+#include "cwsw_bsp_matrix.h"		/* di_matrix_drive_row() et. al. */
+
+
+// ============================================================================
+// ----	Constants -------------------------------------------------------------
+// ============================================================================
+
+/*	cbHEARTBEAT_ACTION(): work done once per tick by bd_none__Run(); the project defines this in
+ *	projcfg.h, typically as `tedlos_schedule(pOsEvqx)`. Replay time follows the CWSW clock, so this
+ *	must advance it; rather than default it to nothing (bd_none__Run() would spin w/ the replay
+ *	frozen), bd_none__Run() is only built when the project defines it.
+ */
+
+enum eReplayFormat {
+	kReplayHeaderSize	= 8,
+	kReplayRecordSize	= 8,
+	kReplayVersion		= 1
+};
+
+/// How the replay buffer was obtained, and so how it is released.
+enum eReplayOwner {
+	kReplayOwnerCaller,		//!< bd_none__ReplayOpenMem(): the caller's buffer, never freed here
+	kReplayOwnerMapped,		//!< mmap view of the file
+	kReplayOwnerHeap		//!< file read into a malloc'd buffer
+};
+
+
+// ============================================================================
+// ----	Type Definitions ------------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Global Variables ------------------------------------------------------
+// ============================================================================
+
+// ============================================================================
+// ----	Module-level Variables ------------------------------------------------
+// ============================================================================
+
+/* the replay, and the inputs it drives, belong to the selected board instance (pBoardInstance);
+ * see tBoardInstance.
+ */
+
+
+// ============================================================================
+// ----	Private Functions -----------------------------------------------------
+// ============================================================================
+
+static uint32_t
+rd_le32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t
+rd_le16(const uint8_t *p)
+{
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/// Read the whole file into memory; the fallback where mmap isn't available, or fails.
+static const uint8_t *
+ReplayLoad(const char *path, size_t *psize)
+{
+	FILE *fp = fopen(path, "rb");
+	uint8_t *pbuf = NULL;
+	long len;
+
+	if(!fp)	{ return NULL; }
+	if((fseek(fp, 0, SEEK_END) == 0) && ((len = ftell(fp)) > 0) && (fseek(fp, 0, SEEK_SET) == 0))
+	{
+		pbuf = (uint8_t *)malloc((size_t)len);
+		if(pbuf && (fread(pbuf, 1, (size_t)len, fp) != (size_t)len))
+		{
+			free(pbuf);
+			pbuf = NULL;
+		}
+		*psize = (size_t)len;
+	}
+	fclose(fp);
+	return pbuf;
+}
+
+/// Apply every record that has come due by the current clock.
+static void
+ReplayAdvance(void)
+{
+	tBoardInstance *pbd = pBoardInstance;
+	tCwswClockTics now = Get(Cwsw_Clock, Now) - pbd->tmReplayStart;
+	const uint8_t *prec;
+	uint32_t idx;
+
+	while(pbd->preplay && (pbd->replaypos + kReplayRecordSize <= pbd->replaysize) && (pbd->tmNextRecord <= now))
+	{
+		prec = &pbd->preplay[pbd->replaypos];
+		idx = rd_le16(&prec[4]);
+		if((idx < kBoardNumButtons) && !prec[7])
+		{
+			if(prec[6])	{ BTNMAP_SET(pbd->buttonstatus, idx); }
+			else		{ BTNMAP_CLR(pbd->buttonstatus, idx); }
+			BTNMAP_SET(pbd->buttonactivity, idx);
+#if (BOARD_BUTTON_EDGE_TIMES)
+			BTNMAP_SET(pbd->buttonedgemask, idx);
+			pbd->buttonedgetime[idx] = pbd->tmReplayStart + pbd->tmNextRecord;
+#endif
+		}
+
+		pbd->replaypos += kReplayRecordSize;
+		if(pbd->replaypos + kReplayRecordSize <= pbd->replaysize)
+		{
+			pbd->tmNextRecord += (tCwswClockTics)rd_le32(&pbd->preplay[pbd->replaypos]);
+		}
+	}
+}
+
+
+// ============================================================================
+// ----	Public Functions ------------------------------------------------------
+// ============================================================================
+
+uint16_t
+bd_none__ReplayOpen(const char *path)
+{
+	tBoardInstance *pbd = pBoardInstance;
+	const uint8_t *pfile = NULL;
+	size_t size = 0;
+	enum eReplayOwner owner = kReplayOwnerHeap;
+	uint16_t rc;
+
+	if(!path)	{ return kErr_Bsp_BadParm; }
+	bd_none__ReplayClose();
+
+#if (REPLAY_HAS_MMAP)
+	{
+		struct stat st;
+		int fd = open(path, O_RDONLY);
+		if(fd >= 0)
+		{
+			if((fstat(fd, &st) == 0) && (st.st_size > 0))
+			{
+				void *pmap = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if(pmap != MAP_FAILED)
+				{
+					pfile = (const uint8_t *)pmap;
+					size = (size_t)st.st_size;
+					owner = kReplayOwnerMapped;
+				}
+			}
+			close(fd);		// the mapping stays valid after the descriptor is closed
+		}
+	}
+#endif
+	if(!pfile)	{ pfile = ReplayLoad(path, &size); }
+	if(!pfile)	{ return kErr_Bsp_InitFailed; }
+
+	rc = bd_none__ReplayOpenMem(pfile, size);
+	if(rc != kErr_Bsp_NoError)
+	{
+		// never taken in as a replay; hand the buffer to Close() only so it is released
+		pbd->preplay = pfile;
+		pbd->replaysize = size;
+	}
+	pbd->replayowner = (uint8_t)owner;
+	if(rc != kErr_Bsp_NoError)	{ bd_none__ReplayClose(); }
+	return rc;
+}
+
+uint16_t
+bd_none__ReplayOpenMem(const void *pscript, size_t size)
+{
+	tBoardInstance *pbd = pBoardInstance;
+	const uint8_t *pfile = (const uint8_t *)pscript;
+	uint32_t idx;
+
+	// a bad script leaves the board as it was; it is never half-open
+	if(!pfile)	{ return kErr_Bsp_BadParm; }
+	if((size < kReplayHeaderSize) || memcmp(pfile, "CWBR", 4) || (pfile[4] != kReplayVersion))
+	{
+		return kErr_Bsp_BadParm;
+	}
+
+	if(pfile != pbd->preplay)	{ bd_none__ReplayClose(); }
+	pbd->preplay = pfile;
+	pbd->replaysize = size;
+	pbd->replayowner = (uint8_t)kReplayOwnerCaller;
+
+	for(idx = 0; idx < kBoardNumButtonWords; ++idx)
+	{
+		pbd->buttonstatus[idx] = 0;
+		pbd->buttonactivity[idx] = 0;
+	}
+	pbd->replaypos = kReplayHeaderSize;
+	pbd->tmReplayStart = Get(Cwsw_Clock, Now);
+	pbd->tmNextRecord = (pbd->replaypos + kReplayRecordSize <= pbd->replaysize) ? (tCwswClockTics)rd_le32(&pbd->preplay[pbd->replaypos]) : 0;
+	return kErr_Bsp_NoError;
+}
+
+void
+bd_none__ReplayClose(void)
+{
+	tBoardInstance *pbd = pBoardInstance;
+
+	if(pbd->preplay)
+	{
+		switch(pbd->replayowner)
+		{
+#if (REPLAY_HAS_MMAP)
+		case kReplayOwnerMapped:
+			(void)munmap((void *)pbd->preplay, pbd->replaysize);
+			break;
+#endif
+		case kReplayOwnerHeap:
+			free((void *)pbd->preplay);
+			break;
+		default:
+			break;
+		}
+	}
+	pbd->preplay = NULL;
+	pbd->replaysize = 0;
+	pbd->replaypos = 0;
+	pbd->replayowner = (uint8_t)kReplayOwnerCaller;
+}
+
+#if defined(cbHEARTBEAT_ACTION)
+uint32_t
+bd_none__Run(uint32_t ticks)
+{
+	uint32_t n;
+	for(n = 0; n < ticks; ++n)
+	{
+		cbHEARTBEAT_ACTION();
+	}
+	return n;
+}
+#endif
+
+bool
+bd_none__ReplayDue(void)
+{
+	tBoardInstance *pbd = pBoardInstance;
+
+	return pbd->preplay && (pbd->replaypos + kReplayRecordSize <= pbd->replaysize) &&
+			(pbd->tmNextRecord <= Get(Cwsw_Clock, Now) - pbd->tmReplayStart);
+}
+
+bool
+Cwsw_Board__Get_ReplayDone(void)
+{
+	tBoardInstance *pbd = pBoardInstance;
+
+	return !pbd->preplay || (pbd->replaypos + kReplayRecordSize > pbd->replaysize);
+}
+
+
+#if (BOARD_BUTTONS_MATRIX)			/* { */
+/*	With the keypad matrix on, the replayed buttons are the keys, and the common matrix driver
+ *	scans them through the hooks below; it also provides the DI readers.
+ */
+
+/** Strobe row `row`. The replay is brought up to date once per scan, as row 0 is strobed, so every
+ *	row of a scan sees the same instant.
+ */
+void
+di_matrix_drive_row(uint32_t row)
+{
+	if(!row)	{ ReplayAdvance(); }
+	pBoardInstance->matrixrow = row;
+}
+
+/** Read the keys of the strobed row from the replayed levels; a row may straddle two bitmap words. */
+tBoardButtonMap
+di_matrix_read_columns(void)
+{
+	tBoardInstance *pbd = pBoardInstance;
+	uint32_t first		= kBoardMatrixFirstButton + (pbd->matrixrow * kBoardMatrixCols);
+	uint32_t idxword	= first / BOARD_BUTTON_MAP_WORD_BITS;
+	uint32_t shift		= first % BOARD_BUTTON_MAP_WORD_BITS;
+	tBoardButtonMap cols = pbd->buttonstatus[idxword] >> shift;
+
+	if(shift && ((shift + kBoardMatrixCols) > BOARD_BUTTON_MAP_WORD_BITS))
+	{
+		cols |= pbd->buttonstatus[idxword + 1] << (BOARD_BUTTON_MAP_WORD_BITS - shift);
+	}
+	return cols;
+}
+
+/** No row lines to release on a replayed keypad. */
+void
+di_matrix_release_rows(void)
+{
+}
+
+#else								/* } { */
+
+/** Sample every button input at once.
+ *	With no replay open, every button reads "released".
+ */
+void
+di_read_button_inputs(tBoardButtonMap *pinputs)
+{
+	tBoardInstance *pbd = pBoardInstance;
+	uint32_t idx;
+
+	if(!pinputs)	{ return; }
+	ReplayAdvance();
+	for(idx = 0; idx < kBoardNumButtonWords; ++idx)	{ pinputs[idx] = pbd->buttonstatus[idx]; }
+}
+
+void
+di_read_button_activity(tBoardButtonMap *pactivity)
+{
+	tBoardInstance *pbd = pBoardInstance;
+	uint32_t idx;
+
+	if(!pactivity)	{ return; }
+	ReplayAdvance();
+	for(idx = 0; idx < kBoardNumButtonWords; ++idx)
+	{
+		pactivity[idx] = pbd->buttonactivity[idx];
+		pbd->buttonactivity[idx] = 0;
+	}
+}
+
+#if (BOARD_BUTTON_EDGE_TIMES)
+void
+di_read_button_edge_times(tBoardButtonMap *pedges, tCwswClockTics *ptimes)
+{
+	tBoardInstance *pbd = pBoardInstance;
+	uint32_t idx;
+
+	if(!pedges || !ptimes)	{ return; }
+	ReplayAdvance();
+	for(idx = 0; idx < kBoardNumButtonWords; ++idx)
+	{
+		pedges[idx] = pbd->buttonedgemask[idx];
+		pbd->buttonedgemask[idx] = 0;
+	}
+	for(idx = 0; idx < kBoardNumButtons; ++idx)
+	{
+		if(BTNMAP_TEST(pedges, idx))	{ ptimes[idx] = pbd->buttonedgetime[idx]; }
+	}
+}
+#endif
+
+#endif								/* } */